@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    Wait-free single producer / single consumer sample fifo for the analyzer.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// The audio thread pushes a mono mix of each block, the analyzer thread pulls it.
+// The buffer is allocated up front; push never allocates, locks or waits. If the
+// reader falls behind the samples that don't fit are dropped, the audio never waits.
+class AnalyzerFifo
+{
+public:
+    explicit AnalyzerFifo(int capacity = 1 << 15) : fifo(capacity), buffer((size_t) capacity) {}
+
+    // audio thread
+    template <typename SampleType>
+    void push(const juce::dsp::AudioBlock<SampleType>& block) noexcept
+    {
+        auto numChannels = (int) block.getNumChannels();
+
+        if(numChannels == 0)
+            return;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite((int) block.getNumSamples(), start1, size1, start2, size2);
+
+        mix(block, 0, buffer.data() + start1, size1);
+        mix(block, size1, buffer.data() + start2, size2);
+
+        fifo.finishedWrite(size1 + size2);
+        numDropped.store(numDropped.load(std::memory_order_relaxed) + (block.getNumSamples() - (size_t) (size1 + size2)),
+                         std::memory_order_relaxed);
+    }
+
+    // analyzer thread, returns how many samples were copied
+    int pull(float* destination, int maxSamples) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(maxSamples, start1, size1, start2, size2);
+
+        std::copy_n(buffer.data() + start1, size1, destination);
+        std::copy_n(buffer.data() + start2, size2, destination + size1);
+
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+    int getNumReady() const noexcept { return fifo.getNumReady(); }
+    juce::uint64 getNumDropped() const noexcept { return numDropped.load(); }
+
+private:
+    template <typename SampleType>
+    static void mix(const juce::dsp::AudioBlock<SampleType>& block, int offset, float* destination, int numSamples) noexcept
+    {
+        if(numSamples <= 0)
+            return;
+
+        auto numChannels = block.getNumChannels();
+        auto gain = 1.0f / (float) numChannels;
+
+        if constexpr (std::is_same<std::remove_const_t<SampleType>, float>::value)
+        {
+            juce::FloatVectorOperations::copyWithMultiply(destination, block.getChannelPointer(0) + offset, gain, numSamples);
+
+            for (size_t ch = 1; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::addWithMultiply(destination, block.getChannelPointer(ch) + offset, gain, numSamples);
+        }
+        else
+        {
+            std::fill_n(destination, numSamples, 0.0f);
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                auto* source = block.getChannelPointer(ch) + offset;
+
+                for (int i = 0; i < numSamples; ++i)
+                    destination[i] += gain * (float) source[i];
+            }
+        }
+    }
+
+    juce::AbstractFifo fifo;
+    std::vector<float> buffer;
+    std::atomic<juce::uint64> numDropped {0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalyzerFifo)
+};
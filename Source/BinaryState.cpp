@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+    Compact, versioned binary encoding of the parameter values, for the
+    plugin state and for preset banks.
+
+  ==============================================================================
+*/
+
+#include "BinaryState.h"
+
+static juce::uint32 fnv1a(juce::uint32 hash, const char* data, size_t size) noexcept
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= (juce::uint8) data[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static float readFloat(const char* p) noexcept
+{
+    auto bits = juce::ByteOrder::littleEndianInt(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+juce::uint32 BinaryState::hashParameterID(const juce::String& paramID) noexcept
+{
+    return fnv1a(2166136261u, paramID.toRawUTF8(), paramID.getNumBytesAsUTF8());
+}
+
+BinaryState::BinaryState(juce::AudioProcessorValueTreeState& apvts)
+{
+    layoutHash = 2166136261u;
+
+    for (auto* param : apvts.processor.getParameters())
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param))
+        {
+            entries.push_back({ ranged, hashParameterID(ranged->paramID) });
+
+            // the terminating zero too, so "a" "bc" and "ab" "c" hash differently
+            layoutHash = fnv1a(layoutHash, ranged->paramID.toRawUTF8(), ranged->paramID.getNumBytesAsUTF8() + 1);
+        }
+    }
+
+   #if JUCE_DEBUG
+    // two IDs with the same hash would restore each other's values
+    for (size_t i = 0; i < entries.size(); ++i)
+        for (size_t j = i + 1; j < entries.size(); ++j)
+            jassert(entries[i].hash != entries[j].hash);
+   #endif
+}
+
+void BinaryState::write(juce::OutputStream& out) const
+{
+    out.writeInt((int) magic);
+    out.writeShort((short) currentVersion);
+    out.writeShort((short) entries.size());
+    out.writeInt((int) layoutHash);
+
+    for (const auto& entry : entries)
+    {
+        out.writeInt((int) entry.hash);
+        out.writeFloat(entry.parameter->convertFrom0to1(entry.parameter->getValue()));
+    }
+}
+
+void BinaryState::write(juce::MemoryBlock& destData) const
+{
+    juce::MemoryOutputStream mos(destData, false);
+    write(mos);
+}
+
+bool BinaryState::isBinaryState(const void* data, size_t sizeInBytes) noexcept
+{
+    return data != nullptr && sizeInBytes >= headerSize && juce::ByteOrder::littleEndianInt(data) == magic;
+}
+
+void BinaryState::setValue(juce::RangedAudioParameter& parameter, float value)
+{
+    // only the ones that change, most of a session's instances sit on mostly default values
+    auto normalised = parameter.convertTo0to1(value);
+
+    if (normalised != parameter.getValue())
+        parameter.setValueNotifyingHost(normalised);
+}
+
+bool BinaryState::read(const void* data, size_t sizeInBytes)
+{
+    if (! isBinaryState(data, sizeInBytes))
+        return false;
+
+    auto* bytes = static_cast<const char*>(data);
+    auto version = (int) juce::ByteOrder::littleEndianShort(bytes + 4);
+    auto numStored = (size_t) juce::ByteOrder::littleEndianShort(bytes + 6);
+    auto storedLayoutHash = juce::ByteOrder::littleEndianInt(bytes + 8);
+
+    if (version > currentVersion || headerSize + numStored * entrySize > sizeInBytes)
+        return false;
+
+    auto* stored = bytes + headerSize;
+
+    // fast path: same parameters in the same order
+    if (storedLayoutHash == layoutHash && numStored == entries.size())
+    {
+        for (size_t i = 0; i < numStored; ++i)
+            setValue(*entries[i].parameter, readFloat(stored + i * entrySize + 4));
+
+        return true;
+    }
+
+    // otherwise by ID. Searching from where the parameter is in our layout finds it straight
+    // away when only some were added or removed at the end.
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        auto& entry = entries[i];
+        auto found = false;
+
+        for (size_t n = 0; n < numStored && ! found; ++n)
+        {
+            auto* e = stored + ((i + n) % numStored) * entrySize;
+
+            if (juce::ByteOrder::littleEndianInt(e) == entry.hash)
+            {
+                setValue(*entry.parameter, readFloat(e + 4));
+                found = true;
+            }
+        }
+
+        if (! found)
+            setValue(*entry.parameter, entry.parameter->convertFrom0to1(entry.parameter->getDefaultValue()));
+    }
+
+    return true;
+}
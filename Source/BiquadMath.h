@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    Allocation free versions of the juce biquad designs, for use on the audio thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+
+// These do the same maths as juce::dsp::IIR::Coefficients<SampleType>::makePeakFilter /
+// makeLowPass / makeHighPass and FilterDesign's butterworth cascades, but return the
+// normalised b0, b1, b2, a1, a2 by value instead of allocating a Coefficients object.
+// SampleType is the precision the maths is done in; the result is always stored as double.
+
+template <typename SampleType>
+inline SectionCoefficients normaliseSection(SampleType b0, SampleType b1, SampleType b2,
+                                            SampleType a0, SampleType a1, SampleType a2) noexcept
+{
+    auto a0inv = a0 != SampleType(0) ? SampleType(1) / a0 : SampleType(0);
+    return { b0 * a0inv, b1 * a0inv, b2 * a0inv, a1 * a0inv, a2 * a0inv };
+}
+
+template <typename SampleType>
+inline SectionCoefficients makePeakSection(double sampleRate, SampleType frequency, SampleType Q, SampleType gainFactor) noexcept
+{
+    constexpr auto pi = juce::MathConstants<SampleType>::pi;
+
+    auto A = juce::jmax(SampleType(0), std::sqrt(gainFactor));
+    auto omega = (2 * pi * juce::jmax(frequency, SampleType(2))) / static_cast<SampleType>(sampleRate);
+    auto alpha = std::sin(omega) / (Q * 2);
+    auto c2 = -2 * std::cos(omega);
+    auto alphaTimesA = alpha * A;
+    auto alphaOverA = alpha / A;
+
+    return normaliseSection<SampleType>(1 + alphaTimesA, c2, 1 - alphaTimesA, 1 + alphaOverA, c2, 1 - alphaOverA);
+}
+
+template <typename SampleType>
+inline SectionCoefficients makeLowPassSection(double sampleRate, SampleType frequency, SampleType Q) noexcept
+{
+    auto n = 1 / std::tan(juce::MathConstants<SampleType>::pi * frequency / static_cast<SampleType>(sampleRate));
+    auto nSquared = n * n;
+    auto invQ = 1 / Q;
+    auto c1 = 1 / (1 + invQ * n + nSquared);
+
+    return normaliseSection<SampleType>(c1, c1 * 2, c1, 1, c1 * 2 * (1 - nSquared), c1 * (1 - invQ * n + nSquared));
+}
+
+template <typename SampleType>
+inline SectionCoefficients makeHighPassSection(double sampleRate, SampleType frequency, SampleType Q) noexcept
+{
+    auto n = std::tan(juce::MathConstants<SampleType>::pi * frequency / static_cast<SampleType>(sampleRate));
+    auto nSquared = n * n;
+    auto invQ = 1 / Q;
+    auto c1 = 1 / (1 + invQ * n + nSquared);
+
+    return normaliseSection<SampleType>(c1, c1 * -2, c1, 1, c1 * 2 * (nSquared - 1), c1 * (1 - invQ * n + nSquared));
+}
+
+// Q of section i of an even order butterworth cascade
+inline double getButterworthQ(int order, int section) noexcept
+{
+    return 1.0 / (2.0 * std::cos((2.0 * section + 1.0) * juce::MathConstants<double>::pi / (order * 2.0)));
+}
+
+// fills the first (slope + 1) sections, returns how many that was
+template <typename SampleType>
+inline int makeCutSections(bool isHighPass, double sampleRate, SampleType frequency, Slope slope,
+                           std::array<SectionCoefficients, 4>& sections) noexcept
+{
+    auto order = (slope + 1) * 2;
+    auto numSections = order / 2;
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        auto Q = static_cast<SampleType>(getButterworthQ(order, i));
+        sections[(size_t) i] = isHighPass ? makeHighPassSection(sampleRate, frequency, Q)
+                                          : makeLowPassSection(sampleRate, frequency, Q);
+    }
+
+    return numSections;
+}
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    Fused biquad cascade: every active section of LowCut, Peak and HighCut
+    in one pass over the samples.
+
+  ==============================================================================
+*/
+
+#include "CascadeKernel.h"
+
+static void addSection(CascadeCoefficients& cascade, const SectionCoefficients& section, int slot) noexcept
+{
+    auto k = (size_t) cascade.numSections++;
+    cascade.sections[k] = section;
+    cascade.slots[k] = slot;
+}
+
+void makeCascade(const FilterCoefficients& c, CascadeCoefficients& cascade) noexcept
+{
+    const auto& cs = c.settings;
+    cascade.numSections = 0;
+    cascade.peakSection = -1;
+
+    // same order as MonoChain: LowCut -> Peak (then the extra peaks) -> HighCut
+    if (! cs.lowCutBypassed)
+        for (int i = 0; i <= cs.lowCutSlope; ++i)
+            addSection(cascade, c.lowCut[(size_t) i], LowCutSlot + i);
+
+    if (! cs.peakBypassed)
+    {
+        cascade.peakSection = cascade.numSections;
+        addSection(cascade, c.peak, PeakSlot);
+    }
+
+    for (int i = 0; i < cs.extraPeaks.numBands; ++i)
+        if (! cs.extraPeaks.bypassed[(size_t) i])
+            addSection(cascade, c.extraPeaks[(size_t) i], ExtraPeakSlot + i);
+
+    if (! cs.highCutBypassed)
+        for (int i = 0; i <= cs.highCutSlope; ++i)
+            addSection(cascade, c.highCut[(size_t) i], HighCutSlot + i);
+}
+
+double getCascadeTailSamples(const CascadeCoefficients& cascade, double decayDecibels) noexcept
+{
+    double total = 0;
+
+    for (int k = 0; k < cascade.numSections; ++k)
+    {
+        // poles are the roots of z^2 + a1 z + a2
+        auto a1 = cascade.sections[(size_t) k][3];
+        auto a2 = cascade.sections[(size_t) k][4];
+        auto discriminant = a1 * a1 - 4.0 * a2;
+
+        double radius;
+
+        if (discriminant < 0)
+        {
+            radius = std::sqrt(a2); // complex pair, |p|^2 = a2
+        }
+        else
+        {
+            auto root = std::sqrt(discriminant);
+            radius = juce::jmax(std::abs(-a1 + root), std::abs(-a1 - root)) * 0.5;
+        }
+
+        // a pole on (or rounding past) the unit circle would ring forever, cap it
+        radius = juce::jmin(radius, 1.0 - 1.0e-9);
+
+        if (radius > 0)
+            total += decayDecibels / (-20.0 * std::log10(radius));
+    }
+
+    return total;
+}
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    Fused biquad cascade: every active section of LowCut, the peak bands and
+    HighCut in one pass over the samples.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CoefficientDesigner.h"
+
+// State slots, fixed per filter position so a band that gets bypassed and
+// un-bypassed picks up where it was, like the ProcessorChain did.
+enum CascadeSlots
+{
+    LowCutSlot = 0,     // .. 3
+    PeakSlot = 4,
+    HighCutSlot = 5,    // .. 8
+    ExtraPeakSlot = 9,  // .. 23
+    NumCascadeSlots = ExtraPeakSlot + MaxExtraPeakBands
+};
+
+// The active sections of a FilterCoefficients set in processing order, with bypassed
+// bands, peak bands beyond the band count and unused cut stages already left out, so the
+// kernel never checks a flag and only pays for the bands in use. Coefficients and state
+// are contiguous arrays indexed by section / slot, structure of arrays style.
+struct CascadeCoefficients
+{
+    std::array<SectionCoefficients, NumCascadeSlots> sections {};
+    std::array<int, NumCascadeSlots> slots {};
+    int numSections {0};
+    int peakSection {-1};       // where the Peak band is, -1 when it's bypassed
+};
+
+void makeCascade(const FilterCoefficients& c, CascadeCoefficients& cascade) noexcept;
+
+// How many samples the cascade keeps ringing after its input stops, until it has decayed by
+// decayDecibels. Taken from the pole radii: a section with its slowest pole at radius r
+// drops by -20 log10(r) dB per sample. Sections are in series, so the sum of their tails
+// is a safe upper bound for the whole cascade.
+double getCascadeTailSamples(const CascadeCoefficients& cascade, double decayDecibels) noexcept;
+
+template <typename SampleType>
+struct CascadeState
+{
+    std::array<SampleType, NumCascadeSlots> s1 {}, s2 {};
+
+    void reset() noexcept
+    {
+        s1.fill(SampleType());
+        s2.fill(SampleType());
+    }
+};
+
+// coefficients are stored in double and rounded to the processing precision here
+template <typename SampleType>
+inline SampleType expandCoefficient(double c) noexcept
+{
+    return SampleType::expand(static_cast<typename SampleType::ElementType>(c));
+}
+
+template <>
+inline float expandCoefficient<float>(double c) noexcept { return static_cast<float>(c); }
+
+template <>
+inline double expandCoefficient<double>(double c) noexcept { return c; }
+
+// Runs every section per sample with coefficients and state held in locals, so the samples
+// are read and written once instead of once per section. Same transposed direct form II
+// and operation order as juce::dsp::IIR::Filter, so each section gives identical results.
+//
+// NumSections is a compile time constant, so the section loop has a fixed trip count the
+// compiler can unroll and keep entirely in registers. There is one instantiation for every
+// count a cascade can have, see processCascade.
+template <typename SampleType, int NumSections>
+void processCascadeSections(const CascadeCoefficients& cascade, CascadeState<SampleType>& state,
+                            SampleType* samples, size_t numSamples) noexcept
+{
+    if constexpr (NumSections == 0)
+    {
+        juce::ignoreUnused(cascade, state, samples, numSamples);
+    }
+    else
+    {
+        jassert(cascade.numSections == NumSections);
+
+        SampleType b0[NumSections], b1[NumSections], b2[NumSections], a1[NumSections], a2[NumSections];
+        SampleType lv1[NumSections], lv2[NumSections];
+
+        for (size_t k = 0; k < (size_t) NumSections; ++k)
+        {
+            const auto& c = cascade.sections[k];
+            b0[k] = expandCoefficient<SampleType>(c[0]);
+            b1[k] = expandCoefficient<SampleType>(c[1]);
+            b2[k] = expandCoefficient<SampleType>(c[2]);
+            a1[k] = expandCoefficient<SampleType>(c[3]);
+            a2[k] = expandCoefficient<SampleType>(c[4]);
+
+            lv1[k] = state.s1[(size_t) cascade.slots[k]];
+            lv2[k] = state.s2[(size_t) cascade.slots[k]];
+        }
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            auto x = samples[i];
+
+            for (size_t k = 0; k < (size_t) NumSections; ++k)
+            {
+                auto y = x * b0[k] + lv1[k];
+                lv1[k] = (x * b1[k]) - (y * a1[k]) + lv2[k];
+                lv2[k] = (x * b2[k]) - (y * a2[k]);
+                x = y;
+            }
+
+            samples[i] = x;
+        }
+
+        for (size_t k = 0; k < (size_t) NumSections; ++k)
+        {
+            state.s1[(size_t) cascade.slots[k]] = lv1[k];
+            state.s2[(size_t) cascade.slots[k]] = lv2[k];
+        }
+    }
+}
+
+template <typename SampleType>
+using CascadeFunction = void (*)(const CascadeCoefficients&, CascadeState<SampleType>&, SampleType*, size_t) noexcept;
+
+template <typename SampleType, size_t... Counts>
+constexpr std::array<CascadeFunction<SampleType>, sizeof...(Counts)> makeCascadeFunctionTable(std::index_sequence<Counts...>) noexcept
+{
+    return { { &processCascadeSections<SampleType, (int) Counts>... } };
+}
+
+// The specialisation for a section count. Slope and bypass changes only change the count,
+// so the pick happens once per block, never inside the sample loop.
+template <typename SampleType>
+CascadeFunction<SampleType> getCascadeFunction(int numSections) noexcept
+{
+    static constexpr auto table = makeCascadeFunctionTable<SampleType>(std::make_index_sequence<NumCascadeSlots + 1>());
+
+    jassert(juce::isPositiveAndNotGreaterThan(numSections, (int) NumCascadeSlots));
+    return table[(size_t) numSections];
+}
+
+template <typename SampleType>
+void processCascade(const CascadeCoefficients& cascade, CascadeState<SampleType>& state,
+                    SampleType* samples, size_t numSamples) noexcept
+{
+    getCascadeFunction<SampleType>(cascade.numSections)(cascade, state, samples, numSamples);
+}
@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+    Process-wide cache of designed butterworth cascades, shared by every
+    instance through a SharedResourcePointer.
+
+  ==============================================================================
+*/
+
+#include "CoefficientCache.h"
+
+template <typename Integer, typename Value>
+static Integer getBits(Value value) noexcept
+{
+    static_assert(sizeof(Integer) == sizeof(Value), "sizes have to match");
+    Integer bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+CoefficientCache::PackedKey CoefficientCache::pack(const Key& key) noexcept
+{
+    // the top bit is always set, so a valid key can never be all zeroes
+    auto frequencyBits = getBits<juce::uint32>(key.frequency);
+    auto flags = (juce::uint64) 0x80000000 | (juce::uint64) ((int) key.slope << 1) | (key.isHighCut ? 1u : 0u);
+
+    return { { ((juce::uint64) frequencyBits << 32) | flags, getBits<juce::uint64>(key.sampleRate) } };
+}
+
+int CoefficientCache::getSet(const PackedKey& key) noexcept
+{
+    // fold both words and mix, the frequency mantissa bits are the ones that vary
+    auto h = key.words[0] ^ (key.words[1] * 0x9e3779b97f4a7c15ull);
+    h ^= h >> 29;
+    h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 32;
+
+    return (int) (h % (juce::uint64) numSets);
+}
+
+bool CoefficientCache::lookup(const Key& key, CutSections& sections) noexcept
+{
+    auto packed = pack(key);
+    auto* set = entries.data() + getSet(packed) * numWays;
+    auto numSections = getNumSections(key);
+
+    for (int way = 0; way < numWays; ++way)
+    {
+        auto& entry = set[way];
+        auto before = entry.sequence.load(std::memory_order_acquire);
+
+        if ((before & 1) != 0)
+            continue; // being rewritten, can't be the one we want anyway
+
+        if (entry.keyWords[0].load(std::memory_order_relaxed) != packed.words[0]
+             || entry.keyWords[1].load(std::memory_order_relaxed) != packed.words[1])
+            continue;
+
+        CutSections copy;
+
+        for (int s = 0; s < numSections; ++s)
+            for (int i = 0; i < 5; ++i)
+                copy[(size_t) s][(size_t) i] = entry.values[(size_t) (s * 5 + i)].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // a writer got in while we were copying: call it a miss rather than spin
+        if (entry.sequence.load(std::memory_order_relaxed) != before)
+            break;
+
+        std::copy(copy.begin(), copy.begin() + numSections, sections.begin());
+        entry.lastUsed.store(clock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void CoefficientCache::insert(const Key& key, const CutSections& sections)
+{
+    const juce::ScopedLock sl(writeLock);
+
+    auto packed = pack(key);
+    auto* set = entries.data() + getSet(packed) * numWays;
+    auto now = clock.load(std::memory_order_relaxed);
+
+    // the same key if it's already there (two instances missed at once), else an empty
+    // entry, else the one that was used longest ago
+    Entry* victim = nullptr;
+    juce::uint32 oldestAge = 0;
+
+    for (int way = 0; way < numWays; ++way)
+    {
+        auto& entry = set[way];
+        PackedKey stored { { entry.keyWords[0].load(std::memory_order_relaxed), entry.keyWords[1].load(std::memory_order_relaxed) } };
+
+        if (stored == packed)
+            return;
+
+        auto age = stored.words[0] == 0 ? std::numeric_limits<juce::uint32>::max()
+                                         : now - entry.lastUsed.load(std::memory_order_relaxed);
+
+        if (victim == nullptr || age > oldestAge)
+        {
+            victim = &entry;
+            oldestAge = age;
+        }
+    }
+
+    if (victim->keyWords[0].load(std::memory_order_relaxed) != 0)
+        evictions.fetch_add(1, std::memory_order_relaxed);
+
+    auto sequence = victim->sequence.load(std::memory_order_relaxed);
+    victim->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    victim->keyWords[0].store(packed.words[0], std::memory_order_relaxed);
+    victim->keyWords[1].store(packed.words[1], std::memory_order_relaxed);
+
+    for (int s = 0; s < getNumSections(key); ++s)
+        for (int i = 0; i < 5; ++i)
+            victim->values[(size_t) (s * 5 + i)].store(sections[(size_t) s][(size_t) i], std::memory_order_relaxed);
+
+    victim->lastUsed.store(clock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+    victim->sequence.store(sequence + 2, std::memory_order_release);
+
+    insertions.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CoefficientCache::clear()
+{
+    const juce::ScopedLock sl(writeLock);
+
+    for (auto& entry : entries)
+    {
+        auto sequence = entry.sequence.load(std::memory_order_relaxed);
+        entry.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        entry.keyWords[0].store(0, std::memory_order_relaxed);
+        entry.keyWords[1].store(0, std::memory_order_relaxed);
+
+        entry.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    hits = 0;
+    misses = 0;
+    insertions = 0;
+    evictions = 0;
+}
+
+CoefficientCache::Statistics CoefficientCache::getStatistics() const noexcept
+{
+    Statistics s;
+    s.hits = hits.load(std::memory_order_relaxed);
+    s.misses = misses.load(std::memory_order_relaxed);
+    s.insertions = insertions.load(std::memory_order_relaxed);
+    s.evictions = evictions.load(std::memory_order_relaxed);
+    return s;
+}
@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    Process-wide cache of designed butterworth cascades, shared by every
+    instance through a SharedResourcePointer.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+
+// A session full of instances with the same cut settings would otherwise design the same
+// cascades over and over, and all of them again whenever the sample rate changes. Sets are
+// keyed by (low / high cut, slope, frequency, sample rate) and kept in a fixed table of
+// numSets x numWays entries, least recently used entry of a set goes first.
+//
+// Lookups are wait-free and safe from any thread, including the audio thread: every entry
+// is guarded by a sequence counter (a seqlock) and a reader that overlaps a write just
+// reports a miss instead of retrying. Inserts are serialised by a lock and never block readers.
+// Everything is stored in atomics, so a torn read is never undefined behaviour, only discarded.
+class CoefficientCache
+{
+public:
+    using CutSections = std::array<SectionCoefficients, 4>;
+
+    struct Key
+    {
+        bool isHighCut {false};
+        Slope slope {Slope_12};
+        float frequency {0};
+        double sampleRate {0};
+    };
+
+    struct Statistics
+    {
+        juce::uint64 hits {0}, misses {0}, insertions {0}, evictions {0};
+
+        double getHitRate() const noexcept { return hits + misses > 0 ? (double) hits / (double) (hits + misses) : 0.0; }
+    };
+
+    static constexpr int numSets = 64, numWays = 4;
+
+    // fills the first (slope + 1) sections and returns true on a hit. Wait free.
+    bool lookup(const Key& key, CutSections& sections) noexcept;
+
+    // not the audio thread, takes a lock against other writers
+    void insert(const Key& key, const CutSections& sections);
+
+    void clear();
+
+    Statistics getStatistics() const noexcept;
+
+private:
+    static constexpr int numValues = 4 * 5;
+
+    struct PackedKey
+    {
+        juce::uint64 words[2];
+        bool operator== (const PackedKey& other) const noexcept { return words[0] == other.words[0] && words[1] == other.words[1]; }
+    };
+
+    struct Entry
+    {
+        std::atomic<juce::uint32> sequence {0};          // odd while being written
+        std::atomic<juce::uint64> keyWords[2] {};        // 0, 0 is never a valid key, so empty entries don't match
+        std::array<std::atomic<double>, numValues> values {};
+        std::atomic<juce::uint32> lastUsed {0};
+    };
+
+    static PackedKey pack(const Key& key) noexcept;
+    static int getSet(const PackedKey& key) noexcept;
+    static int getNumSections(const Key& key) noexcept { return key.slope + 1; }
+
+    std::array<Entry, (size_t) (numSets * numWays)> entries;
+
+    juce::CriticalSection writeLock;
+    std::atomic<juce::uint32> clock {0};                // stamps lastUsed
+
+    std::atomic<juce::uint64> hits {0}, misses {0}, insertions {0}, evictions {0};
+};
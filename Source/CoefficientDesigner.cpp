@@ -0,0 +1,236 @@
+/*
+  ==============================================================================
+
+    Builds complete coefficient sets off the audio thread and hands them
+    to the audio thread through a single wait-free slot.
+
+  ==============================================================================
+*/
+
+#include "CoefficientDesigner.h"
+#include "CascadeKernel.h"
+#include "BiquadMath.h"
+
+template <typename CoefficientsPtr>
+static void copyRaw(const CoefficientsPtr& src, SectionCoefficients& dst)
+{
+    jassert(src->coefficients.size() == (int) dst.size());  // should always be a biquad
+    auto* raw = src->getRawCoefficients();
+    std::copy(raw, raw + dst.size(), dst.begin());
+}
+
+// each of these designs one band of c from c.settings and c.sampleRate
+
+static void designPeak(FilterCoefficients& c)
+{
+    copyRaw(makePeakFilter<double>(c.settings, c.sampleRate), c.peak);
+
+    // the extra bands share the Peak generation. Same maths as makePeakFilter, without
+    // allocating a Coefficients object per band.
+    const auto& extra = c.settings.extraPeaks;
+
+    for (size_t i = 0; i < (size_t) extra.numBands; ++i)
+        c.extraPeaks[i] = makePeakSection(c.sampleRate, (double) extra.freq[i], (double) extra.q[i],
+                                          juce::Decibels::decibelsToGain((double) extra.gainInDecibels[i]));
+}
+
+// the butterworth designs only return as many sections as the slope needs,
+// the remaining stages are left out by makeCascade anyway. With a cache, a hit skips
+// the design entirely and a miss is added for the next instance that asks.
+
+static void designCut(bool isHighCut, FilterCoefficients& c, CoefficientCache* cache)
+{
+    auto& sections = isHighCut ? c.highCut : c.lowCut;
+
+    CoefficientCache::Key key;
+    key.isHighCut = isHighCut;
+    key.slope = isHighCut ? c.settings.highCutSlope : c.settings.lowCutSlope;
+    key.frequency = isHighCut ? c.settings.highCutFreq : c.settings.lowCutFreq;
+    key.sampleRate = c.sampleRate;
+
+    if (cache != nullptr && cache->lookup(key, sections))
+        return;
+
+    auto designed = isHighCut ? makeHighCutFilter<double>(c.settings, c.sampleRate)
+                              : makeLowCutFilter<double>(c.settings, c.sampleRate);
+
+    for (int i = 0; i < designed.size(); ++i)
+        copyRaw(designed[i], sections[(size_t) i]);
+
+    if (cache != nullptr)
+        cache->insert(key, sections);
+}
+
+static void designLowCut(FilterCoefficients& c, CoefficientCache* cache)
+{
+    designCut(false, c, cache);
+}
+
+static void designHighCut(FilterCoefficients& c, CoefficientCache* cache)
+{
+    designCut(true, c, cache);
+}
+
+// down to -120 dB, which is well below anything that survives to the output
+static void updateTail(FilterCoefficients& c)
+{
+    CascadeCoefficients cascade;
+    makeCascade(c, cascade);
+    c.tailSeconds = getCascadeTailSamples(cascade, 120.0) / c.sampleRate;
+}
+
+FilterCoefficients::Ptr designCoefficients(const ChainSettings& chainSettings, double sampleRate, CoefficientCache* cache)
+{
+    FilterCoefficients::Ptr c = new FilterCoefficients();
+    c->settings = chainSettings;
+    c->sampleRate = sampleRate;
+
+    designPeak(*c);
+    designLowCut(*c, cache);
+    designHighCut(*c, cache);
+    updateTail(*c);
+
+    return c;
+}
+
+//==============================================================================
+CoefficientDesigner::CoefficientDesigner(ParameterSnapshot& p) : parameters(p)
+{
+    // something to publish before prepareToPlay, prepareToPlay redesigns at the real rate
+    designNow(defaultSampleRate);
+
+    thread->addTimeSliceClient(this);
+}
+
+CoefficientDesigner::~CoefficientDesigner()
+{
+    // blocks until we are not inside useTimeSlice any more
+    thread->removeTimeSliceClient(this);
+
+    if (auto* stale = pending.exchange(nullptr))
+        stale->decReferenceCount();
+}
+
+FilterCoefficients::Ptr CoefficientDesigner::designNow(double newSampleRate)
+{
+    const juce::ScopedLock sl(designLock);
+
+    sampleRate = newSampleRate;
+
+    // read the generations first: anything that moves after this gets picked up on the next poll
+    designedGenerations = getGenerations();
+
+    auto c = designCoefficients(parameters.getChainSettings(), newSampleRate * parameters.getOversamplingFactor(), cache.get());
+    latest = c;
+    pool.add(c);
+
+    // whatever is still waiting was designed for the old sample rate
+    if (auto* stale = pending.exchange(nullptr))
+        stale->decReferenceCount();
+
+    current = c;
+    share(c);
+    return c;
+}
+
+FilterCoefficients* CoefficientDesigner::getNextCoefficients() noexcept
+{
+    auto* next = pending.exchange(nullptr);
+
+    if (next == nullptr)
+        return nullptr;
+
+    // take over the reference the slot was holding. The pool still refers to both the
+    // new and the old set, so neither count can reach zero here.
+    current = next;
+    next->decReferenceCountWithoutDeleting();
+
+    return next;
+}
+
+int CoefficientDesigner::useTimeSlice()
+{
+    {
+        const juce::ScopedLock sl(designLock);
+
+        if (sampleRate > 0 && latest != nullptr)
+        {
+            auto generations = getGenerations();
+
+            if (generations != designedGenerations)
+            {
+                auto c = redesign(generations);
+                publish(c);
+                share(c);
+            }
+        }
+
+        collectGarbage();
+    }
+
+    return 5; // ms until we look again
+}
+
+CoefficientDesigner::Generations CoefficientDesigner::getGenerations() const noexcept
+{
+    return { parameters.getGeneration(LowCut),
+             parameters.getGeneration(Peak),
+             parameters.getGeneration(HighCut) };
+}
+
+FilterCoefficients::Ptr CoefficientDesigner::redesign(const Generations& generations)
+{
+    // start from the previous set and only redo the bands whose generation moved
+    FilterCoefficients::Ptr c = new FilterCoefficients(*latest);
+    c->settings = parameters.getChainSettings();
+    c->sampleRate = sampleRate * parameters.getOversamplingFactor();
+
+    if (generations[LowCut] != designedGenerations[LowCut])
+        designLowCut(*c, cache.get());
+
+    if (generations[Peak] != designedGenerations[Peak])
+        designPeak(*c);
+
+    if (generations[HighCut] != designedGenerations[HighCut])
+        designHighCut(*c, cache.get());
+
+    updateTail(*c);
+
+    designedGenerations = generations;
+    latest = c;
+    return c;
+}
+
+void CoefficientDesigner::publish(FilterCoefficients::Ptr c)
+{
+    pool.add(c);
+
+    c->incReferenceCount(); // owned by the slot until the audio thread picks it up
+
+    // if the audio thread never saw the previous one, just let it go
+    if (auto* skipped = pending.exchange(c.get()))
+        skipped->decReferenceCount();
+}
+
+void CoefficientDesigner::share(const FilterCoefficients::Ptr& c)
+{
+    // the pool still refers to whatever this replaces, so nothing is freed under the lock
+    {
+        const juce::SpinLock::ScopedLockType sl(publishedLock);
+        published = c;
+    }
+
+    ++publishedGeneration;
+}
+
+FilterCoefficients::Ptr CoefficientDesigner::getPublished() const
+{
+    const juce::SpinLock::ScopedLockType sl(publishedLock);
+    return published;
+}
+
+void CoefficientDesigner::collectGarbage()
+{
+    // a count of one means only the pool knows about it: not current, not pending
+    pool.removeIf([](const FilterCoefficients::Ptr& c) { return c->getReferenceCount() == 1; });
+}
@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    Builds complete coefficient sets off the audio thread and hands them
+    to the audio thread through a single wait-free slot.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+#include "ParameterSnapshot.h"
+#include "CoefficientCache.h"
+
+// One complete, immutable set of coefficients for the whole chain, designed in double.
+// Allocated and freed on the designer thread only, the audio thread just reads it.
+struct FilterCoefficients : juce::ReferenceCountedObject
+{
+    using Ptr = juce::ReferenceCountedObjectPtr<FilterCoefficients>;
+
+    ChainSettings settings;
+    double sampleRate {0};      // the rate it was designed for, host rate x oversampling factor
+    double tailSeconds {0};     // how long the cascade rings on after the input stops
+
+    SectionCoefficients peak {};
+    std::array<SectionCoefficients, MaxExtraPeakBands> extraPeaks {};  // only the first settings.extraPeaks.numBands are designed
+    std::array<SectionCoefficients, 4> lowCut {}, highCut {};
+};
+
+// the cut bands come from the cache when one is given and it has them
+FilterCoefficients::Ptr designCoefficients(const ChainSettings& chainSettings, double sampleRate,
+                                           CoefficientCache* cache = nullptr);
+
+//==============================================================================
+// Polls the per-band generations of a ParameterSnapshot on a shared background thread
+// and redesigns only the bands that moved. An instance whose parameters sit still costs
+// three atomic loads per poll and nothing at all on the audio thread.
+//
+// Handoff: the designer stores a new set in `pending` (holding one reference for the slot),
+// the audio thread exchanges it out and keeps it in `current`. Every set also sits in `pool`
+// until only the pool refers to it, so the audio thread never drops the last reference
+// and never frees anything.
+//
+// The same sets are shared with everything else that wants them (the editors' response
+// curves): the newest one is kept in `published` with a generation counter, so a consumer
+// polls one atomic and only takes the lock when there's something new. Design work happens
+// once per change, however many editors are open. Until prepareToPlay the sets are designed
+// at defaultSampleRate, so an editor opened before playback still has a curve.
+class CoefficientDesigner : private juce::TimeSliceClient
+{
+public:
+    CoefficientDesigner(ParameterSnapshot& parameters);
+    ~CoefficientDesigner() override;
+
+    // designs synchronously on the calling thread, drops anything pending and makes the
+    // result current. For prepareToPlay, never the audio thread.
+    // sampleRate is the host rate, sets are designed (and stamped) at the oversampled rate.
+    FilterCoefficients::Ptr designNow(double sampleRate);
+
+    // audio thread only. Wait free: returns the new set if one was published since
+    // the last call, otherwise nullptr.
+    FilterCoefficients* getNextCoefficients() noexcept;
+
+    static constexpr double defaultSampleRate = 44100.0;
+
+    // the newest set, for anyone but the audio thread. Any thread, doesn't wait for a redesign.
+    FilterCoefficients::Ptr getPublished() const;
+
+    // bumped every time a new set is published. Any thread, one atomic load.
+    juce::uint32 getPublishedGeneration() const noexcept { return publishedGeneration.load(); }
+
+    // shared by every designer in the process, for its hit counters
+    const CoefficientCache& getCache() const noexcept { return *cache; }
+
+private:
+    using Generations = std::array<juce::uint32, 3>;
+
+    int useTimeSlice() override;
+
+    Generations getGenerations() const noexcept;
+    FilterCoefficients::Ptr redesign(const Generations&);
+    void publish(FilterCoefficients::Ptr);
+    void share(const FilterCoefficients::Ptr&);
+    void collectGarbage();
+
+    struct DesignThread : juce::TimeSliceThread
+    {
+        DesignThread() : juce::TimeSliceThread("SimpleEQ designer") { startThread(); }
+        ~DesignThread() override { stopThread(1000); }
+    };
+
+    ParameterSnapshot& parameters;
+    juce::SharedResourcePointer<DesignThread> thread;   // one thread for every instance in the process
+    juce::SharedResourcePointer<CoefficientCache> cache;    // and one cache
+
+    std::atomic<double> sampleRate {0};
+
+    juce::CriticalSection designLock;                   // designer thread vs prepareToPlay
+    juce::Array<FilterCoefficients::Ptr> pool;
+    FilterCoefficients::Ptr latest;                     // last set designed, the base for the next one
+    Generations designedGenerations {};
+
+    std::atomic<FilterCoefficients*> pending {nullptr};
+    FilterCoefficients::Ptr current;                    // only touched by the audio thread
+
+    mutable juce::SpinLock publishedLock;               // held for a pointer copy, no longer
+    FilterCoefficients::Ptr published;
+    std::atomic<juce::uint32> publishedGeneration {0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CoefficientDesigner)
+};
@@ -0,0 +1,195 @@
+/*
+  ==============================================================================
+
+    Ramps frequency, gain and Q between coefficient sets at a control rate.
+
+  ==============================================================================
+*/
+
+#include "CoefficientSmoother.h"
+
+void CoefficientSmoother::prepare(double newSampleRate, double rampLengthSeconds, int newControlInterval)
+{
+    sampleRate = newSampleRate;
+    controlInterval = juce::jmax(1, newControlInterval);
+
+    for (auto* s : { &lowCutFreq, &highCutFreq, &peakFreq, &peakQ })
+        s->reset(sampleRate, rampLengthSeconds);
+
+    peakGain.reset(sampleRate, rampLengthSeconds);
+
+    for (size_t i = 0; i < (size_t) MaxExtraPeakBands; ++i)
+    {
+        extraPeakFreq[i].reset(sampleRate, rampLengthSeconds);
+        extraPeakQ[i].reset(sampleRate, rampLengthSeconds);
+        extraPeakGain[i].reset(sampleRate, rampLengthSeconds);
+    }
+}
+
+void CoefficientSmoother::reset(const FilterCoefficients& c) noexcept
+{
+    target = &c;
+
+    const auto& cs = c.settings;
+    lowCutFreq.setCurrentAndTargetValue(cs.lowCutFreq);
+    highCutFreq.setCurrentAndTargetValue(cs.highCutFreq);
+    peakFreq.setCurrentAndTargetValue(cs.peakFreq);
+    peakQ.setCurrentAndTargetValue(cs.peakQ);
+    peakGain.setCurrentAndTargetValue(cs.peakGainInDecibels);
+
+    const auto& extra = cs.extraPeaks;
+    numExtraPeakBands = extra.numBands;
+
+    for (size_t i = 0; i < (size_t) extra.numBands; ++i)
+    {
+        extraPeakFreq[i].setCurrentAndTargetValue(extra.freq[i]);
+        extraPeakQ[i].setCurrentAndTargetValue(extra.q[i]);
+        extraPeakGain[i].setCurrentAndTargetValue(extra.gainInDecibels[i]);
+    }
+}
+
+void CoefficientSmoother::setTarget(const FilterCoefficients& c) noexcept
+{
+    target = &c;
+
+    const auto& cs = c.settings;
+    lowCutFreq.setTargetValue(cs.lowCutFreq);
+    highCutFreq.setTargetValue(cs.highCutFreq);
+    peakFreq.setTargetValue(cs.peakFreq);
+    peakQ.setTargetValue(cs.peakQ);
+    peakGain.setTargetValue(cs.peakGainInDecibels);
+
+    // a band that just came into use starts where it is, it wasn't sounding before
+    const auto& extra = cs.extraPeaks;
+    auto previousNumBands = numExtraPeakBands;
+    numExtraPeakBands = extra.numBands;
+
+    for (size_t i = 0; i < (size_t) extra.numBands; ++i)
+    {
+        if ((int) i < previousNumBands)
+        {
+            extraPeakFreq[i].setTargetValue(extra.freq[i]);
+            extraPeakQ[i].setTargetValue(extra.q[i]);
+            extraPeakGain[i].setTargetValue(extra.gainInDecibels[i]);
+        }
+        else
+        {
+            extraPeakFreq[i].setCurrentAndTargetValue(extra.freq[i]);
+            extraPeakQ[i].setCurrentAndTargetValue(extra.q[i]);
+            extraPeakGain[i].setCurrentAndTargetValue(extra.gainInDecibels[i]);
+        }
+    }
+}
+
+bool CoefficientSmoother::isSmoothing() const noexcept
+{
+    return isLowCutSmoothing() || isHighCutSmoothing() || isPeakSmoothing() || isAnyExtraPeakSmoothing();
+}
+
+bool CoefficientSmoother::isAnyExtraPeakSmoothing() const noexcept
+{
+    for (size_t i = 0; i < (size_t) numExtraPeakBands; ++i)
+        if (isExtraPeakSmoothing(i))
+            return true;
+
+    return false;
+}
+
+const FilterCoefficients& CoefficientSmoother::advance(int numSamples) noexcept
+{
+    jassert(target != nullptr);
+
+    auto lowCut = isLowCutSmoothing();
+    auto highCut = isHighCutSmoothing();
+    auto peak = isPeakSmoothing();
+
+    lowCutFreq.skip(numSamples);
+    highCutFreq.skip(numSamples);
+    peakFreq.skip(numSamples);
+    peakQ.skip(numSamples);
+    peakGain.skip(numSamples);
+
+    // which extra bands were moving, before the skip maybe finishes them
+    std::array<bool, MaxExtraPeakBands> extraPeak {};
+
+    for (size_t i = 0; i < (size_t) numExtraPeakBands; ++i)
+    {
+        extraPeak[i] = isExtraPeakSmoothing(i);
+        extraPeakFreq[i].skip(numSamples);
+        extraPeakQ[i].skip(numSamples);
+        extraPeakGain[i].skip(numSamples);
+    }
+
+    if (! isSmoothing())
+        return *target;
+
+    // slopes, bypass and every band that isn't moving come straight from the target.
+    // Designs use the target's rate, which includes any oversampling.
+    working.settings = target->settings;
+    working.sampleRate = target->sampleRate;
+
+    auto& cs = working.settings;
+    int sections = 0;
+
+    if (lowCut)
+    {
+        cs.lowCutFreq = lowCutFreq.getCurrentValue();
+        sections += tables->makeCutSections(true, working.sampleRate, (double) cs.lowCutFreq, cs.lowCutSlope, working.lowCut);
+    }
+    else
+    {
+        working.lowCut = target->lowCut;
+    }
+
+    if (highCut)
+    {
+        cs.highCutFreq = highCutFreq.getCurrentValue();
+        sections += tables->makeCutSections(false, working.sampleRate, (double) cs.highCutFreq, cs.highCutSlope, working.highCut);
+    }
+    else
+    {
+        working.highCut = target->highCut;
+    }
+
+    if (peak)
+    {
+        cs.peakFreq = peakFreq.getCurrentValue();
+        cs.peakQ = peakQ.getCurrentValue();
+        cs.peakGainInDecibels = peakGain.getCurrentValue();
+
+        working.peak = tables->makePeakSection(working.sampleRate, (double) cs.peakFreq, (double) cs.peakQ,
+                                               (double) cs.peakGainInDecibels);
+        ++sections;
+    }
+    else
+    {
+        working.peak = target->peak;
+    }
+
+    auto& extra = cs.extraPeaks;
+
+    for (size_t i = 0; i < (size_t) extra.numBands; ++i)
+    {
+        if (extraPeak[i])
+        {
+            extra.freq[i] = extraPeakFreq[i].getCurrentValue();
+            extra.q[i] = extraPeakQ[i].getCurrentValue();
+            extra.gainInDecibels[i] = extraPeakGain[i].getCurrentValue();
+
+            working.extraPeaks[i] = tables->makePeakSection(working.sampleRate, (double) extra.freq[i], (double) extra.q[i],
+                                                            (double) extra.gainInDecibels[i]);
+            ++sections;
+        }
+        else
+        {
+            working.extraPeaks[i] = target->extraPeaks[i];
+        }
+    }
+
+    // the audio thread is the only writer, so a load and a store, no locked RMW
+    constexpr auto relaxed = std::memory_order_relaxed;
+    numUpdates.store(numUpdates.load(relaxed) + 1, relaxed);
+    numSectionsDesigned.store(numSectionsDesigned.load(relaxed) + (juce::uint64) sections, relaxed);
+
+    return working;
+}
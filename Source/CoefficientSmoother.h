@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    Ramps frequency, gain and Q between coefficient sets at a control rate.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CoefficientDesigner.h"
+#include "CoefficientTables.h"
+
+// When a new set arrives from the designer, the continuous parameters (cut frequencies,
+// frequency / gain / Q of every peak band) glide towards it instead of jumping. While
+// anything is ramping the audio thread redesigns the moving bands every `controlInterval` samples with the
+// table driven designs in CoefficientTables.h (in double, like the designer, and no
+// trig per update, so a control interval of 1 is affordable). The filter state
+// is left alone, only the coefficients change. Slope and bypass changes still switch immediately.
+//
+// Cost is bounded: at most ceil(blockSize / controlInterval) updates per block, each
+// designing at most the moving sections, and nothing at all once the ramps have finished.
+class CoefficientSmoother
+{
+public:
+    // sampleRate and controlInterval are at the host rate: advance() counts host samples
+    // even when the chain runs oversampled
+    void prepare(double sampleRate, double rampLengthSeconds, int controlInterval);
+
+    // jump straight to c, no ramp
+    void reset(const FilterCoefficients& c) noexcept;
+
+    // start ramping towards c. c has to stay alive until the next setTarget / reset,
+    // which the designer guarantees for its current set.
+    void setTarget(const FilterCoefficients& c) noexcept;
+
+    bool isSmoothing() const noexcept;
+
+    // the set being ramped towards, nullptr before the first reset
+    const FilterCoefficients* getTarget() const noexcept { return target; }
+    int getControlInterval() const noexcept { return controlInterval; }
+
+    // move on by numSamples and return the coefficients to use for them. Once the
+    // ramps are done this returns the target itself, so we land exactly on the designer's set.
+    const FilterCoefficients& advance(int numSamples) noexcept;
+
+    // cost counters, may be read from any thread
+    juce::uint64 getNumUpdates() const noexcept { return numUpdates.load(); }
+    juce::uint64 getNumSectionsDesigned() const noexcept { return numSectionsDesigned.load(); }
+
+private:
+    bool isLowCutSmoothing() const noexcept { return lowCutFreq.isSmoothing(); }
+    bool isHighCutSmoothing() const noexcept { return highCutFreq.isSmoothing(); }
+    bool isPeakSmoothing() const noexcept { return peakFreq.isSmoothing() || peakGain.isSmoothing() || peakQ.isSmoothing(); }
+    bool isExtraPeakSmoothing(size_t band) const noexcept
+    {
+        return extraPeakFreq[band].isSmoothing() || extraPeakGain[band].isSmoothing() || extraPeakQ[band].isSmoothing();
+    }
+    bool isAnyExtraPeakSmoothing() const noexcept;
+
+    using Multiplicative = juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>;
+
+    Multiplicative lowCutFreq, highCutFreq, peakFreq, peakQ;
+    juce::SmoothedValue<float> peakGain; // in dB, so linear is fine
+    
+    // the extra peak bands, same as the first one
+    std::array<Multiplicative, MaxExtraPeakBands> extraPeakFreq, extraPeakQ;
+    std::array<juce::SmoothedValue<float>, MaxExtraPeakBands> extraPeakGain;
+
+    int numExtraPeakBands {0};          // in use in the target, the rest aren't looked at
+
+    const FilterCoefficients* target {nullptr};
+    FilterCoefficients working;
+
+    double sampleRate {0};
+    int controlInterval {32};
+
+    std::atomic<juce::uint64> numUpdates {0}, numSectionsDesigned {0};
+    
+    juce::SharedResourcePointer<CoefficientTables> tables;  // built once per process
+};
@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    Table driven versions of the BiquadMath designs: no sin / cos / tan / pow
+    per redesign, just table lookups and a log2.
+
+  ==============================================================================
+*/
+
+#include "CoefficientTables.h"
+#include "BiquadMath.h"
+
+CoefficientTables::CoefficientTables()
+{
+    // index 0 is 0.5 (nyquist), index n is 0.5 * 2^(-n / pointsPerOctave)
+    constexpr auto numPoints = pointsPerOctave * numOctaves + 1;
+    sinCos.resize((size_t) numPoints);
+
+    for (int n = 0; n < numPoints; ++n)
+    {
+        auto w = juce::MathConstants<double>::pi * std::exp2(-(double) n / pointsPerOctave);
+        sinCos[(size_t) n] = { w, std::sin(w), std::cos(w) };
+    }
+
+    auto numGains = juce::roundToInt((maxGainInDecibels - minGainInDecibels) / gainStep) + 1;
+    gainRoots.resize((size_t) numGains);
+
+    for (int n = 0; n < numGains; ++n)
+        gainRoots[(size_t) n] = std::pow(10.0, (minGainInDecibels + n * gainStep) / 40.0);
+
+    for (int slope = Slope_12; slope <= Slope_48; ++slope)
+        for (int i = 0; i <= slope; ++i)
+            butterworthQ[(size_t) slope][(size_t) i] = getButterworthQ((slope + 1) * 2, i);
+}
+
+CoefficientTables::SinCos CoefficientTables::getSinCos(double frequency, double sampleRate) const noexcept
+{
+    // nearest grid point below nyquist, then the angle addition formulas for the little
+    // bit left over. |d| is at most half a step, so a few Taylor terms are exact to ~1e-13.
+    auto w = juce::MathConstants<double>::twoPi * juce::jmax(1.0e-12, frequency / sampleRate);
+    auto position = -std::log2(w / juce::MathConstants<double>::pi) * pointsPerOctave;
+    auto index = (size_t) juce::jlimit(0, (int) sinCos.size() - 1, juce::roundToInt(position));
+
+    const auto& p = sinCos[index];
+    auto d = w - p.w;
+    auto d2 = d * d;
+
+    auto sinD = d * (1 - d2 / 6 * (1 - d2 / 20));
+    auto cosD = 1 - d2 / 2 * (1 - d2 / 12 * (1 - d2 / 30));
+
+    return { w, p.sinW * cosD + p.cosW * sinD,
+                p.cosW * cosD - p.sinW * sinD };
+}
+
+double CoefficientTables::getGainFactorRoot(double gainInDecibels) const noexcept
+{
+    // 10^(dB / 40) from the nearest step below, times e^x for the rest (x < 0.029)
+    auto position = (juce::jlimit(minGainInDecibels, maxGainInDecibels, gainInDecibels) - minGainInDecibels) / gainStep;
+    auto index = juce::jmin((size_t) position, gainRoots.size() - 1);
+
+    auto x = (position - (double) index) * gainStep * (2.302585092994046 / 40.0); // ln(10) / 40 per dB
+    auto expX = 1 + x * (1 + x / 2 * (1 + x / 3 * (1 + x / 4 * (1 + x / 5 * (1 + x / 6)))));
+
+    return gainRoots[index] * expX;
+}
+
+SectionCoefficients CoefficientTables::makePeakSection(double sampleRate, double frequency, double Q, double gainInDecibels) const noexcept
+{
+    // same maths as ::makePeakSection, with A = sqrt(gainFactor) = 10^(dB / 40)
+    auto A = getGainFactorRoot(gainInDecibels);
+    auto sc = getSinCos(juce::jmax(frequency, 2.0), sampleRate);
+
+    auto alpha = sc.sinW / (Q * 2);
+    auto c2 = -2 * sc.cosW;
+    auto alphaTimesA = alpha * A;
+    auto alphaOverA = alpha / A;
+
+    return normaliseSection<double>(1 + alphaTimesA, c2, 1 - alphaTimesA, 1 + alphaOverA, c2, 1 - alphaOverA);
+}
+
+SectionCoefficients CoefficientTables::makeBandPassSection(double sampleRate, double frequency, double Q) const noexcept
+{
+    // as juce's makeBandPass
+    auto sc = getSinCos(juce::jmax(frequency, 2.0), sampleRate);
+    auto alpha = sc.sinW / (Q * 2);
+
+    return normaliseSection<double>(alpha, 0, -alpha, 1 + alpha, -2 * sc.cosW, 1 - alpha);
+}
+
+int CoefficientTables::makeCutSections(bool isHighPass, double sampleRate, double frequency, Slope slope,
+                                       std::array<SectionCoefficients, 4>& sections) const noexcept
+{
+    // tan(w / 2) without the tan, and the same for every section of the cascade
+    auto sc = getSinCos(frequency, sampleRate);
+    auto tanHalf = sc.sinW / (1 + sc.cosW);
+    auto n = isHighPass ? tanHalf : 1 / tanHalf;
+    auto nSquared = n * n;
+
+    auto numSections = slope + 1;
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        auto invQ = 1 / butterworthQ[(size_t) slope][(size_t) i];
+        auto c1 = 1 / (1 + invQ * n + nSquared);
+
+        // as makeHighPassSection / makeLowPassSection
+        sections[(size_t) i] = isHighPass
+            ? normaliseSection<double>(c1, c1 * -2, c1, 1, c1 * 2 * (nSquared - 1), c1 * (1 - invQ * n + nSquared))
+            : normaliseSection<double>(c1, c1 * 2, c1, 1, c1 * 2 * (1 - nSquared), c1 * (1 - invQ * n + nSquared));
+    }
+
+    return numSections;
+}
@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+    Dynamic gain for the first peak band, from an envelope follower running
+    at a decimated control rate.
+
+  ==============================================================================
+*/
+
+#include "DynamicPeak.h"
+
+void DynamicPeak::prepare(double newHostSampleRate, int maximumBlockSize)
+{
+    hostSampleRate = newHostSampleRate;
+
+    // one step per stepLength, plus the partial ones at either end of a chunk
+    steps.resize((size_t) (maximumBlockSize / stepLength + 2));
+
+    attackMs = releaseMs = -1; // coefficients depend on the rate, work them out again
+    setSettings(settings);
+    reset();
+}
+
+void DynamicPeak::reset() noexcept
+{
+    s1 = s2 = 0;
+    sum = 0;
+    samplesUntilDecimated = decimation;
+    level = 0;
+    envelope = -200;
+    samplesUntilStep = stepLength;
+    stepInControl = 0;
+    numSteps = 0;
+
+    if (processingRate > 0)
+        previousSection = nextSection = tables->makePeakSection(processingRate, frequency, Q, staticGain);
+
+    currentGain.store((float) staticGain, std::memory_order_relaxed);
+}
+
+void DynamicPeak::setSettings(const DynamicPeakSettings& newSettings) noexcept
+{
+    settings = newSettings;
+
+    if (hostSampleRate <= 0 || (settings.attackMs == attackMs && settings.releaseMs == releaseMs))
+        return;
+
+    // one pole per control period, time constant in ms
+    attackMs = settings.attackMs;
+    releaseMs = settings.releaseMs;
+
+    auto controlPeriod = (double) (stepLength * stepsPerControl);
+    attackCoefficient = std::exp(-controlPeriod / (juce::jmax(0.01, (double) attackMs) * 0.001 * hostSampleRate));
+    releaseCoefficient = std::exp(-controlPeriod / (juce::jmax(0.01, (double) releaseMs) * 0.001 * hostSampleRate));
+}
+
+void DynamicPeak::setCoefficients(const FilterCoefficients& c) noexcept
+{
+    const auto& cs = c.settings;
+    auto rateChanged = c.sampleRate != processingRate;
+
+    peakBypassed = cs.peakBypassed;
+    frequency = (double) cs.peakFreq;
+    Q = (double) cs.peakQ;
+    staticGain = (double) cs.peakGainInDecibels;
+    processingRate = c.sampleRate;
+
+    if (hostSampleRate > 0)
+        updateBandPass();
+
+    // the old sections mean nothing at another rate. Otherwise the next control point
+    // picks up the new settings and glides there.
+    if (rateChanged)
+        previousSection = nextSection = tables->makePeakSection(processingRate, frequency, Q, staticGain);
+}
+
+void DynamicPeak::updateBandPass() noexcept
+{
+    // D divides stepLength, so a step never ends halfway through a decimated sample
+    auto newDecimation = 1;
+
+    while (newDecimation < stepLength && frequency * 16.0 * (newDecimation * 2) <= hostSampleRate)
+        newDecimation *= 2;
+
+    // the state means nothing at another rate, start the band pass (not the envelope) again
+    if (newDecimation != decimation)
+    {
+        decimation = newDecimation;
+        s1 = s2 = 0;
+        sum = 0;
+        samplesUntilDecimated = decimation;
+    }
+
+    bandPass = tables->makeBandPassSection(hostSampleRate / decimation, frequency, Q);
+}
+
+void DynamicPeak::updateControl() noexcept
+{
+    // peak level over the period, smoothed in dB
+    auto levelDb = juce::Decibels::gainToDecibels(level, -200.0);
+    auto coefficient = levelDb > envelope ? attackCoefficient : releaseCoefficient;
+    envelope = levelDb + coefficient * (envelope - levelDb);
+    level = 0;
+
+    auto over = juce::jmax(0.0, envelope - (double) settings.thresholdInDecibels);
+    auto gain = staticGain - over * (1.0 - 1.0 / juce::jmax(1.0, (double) settings.ratio));
+    gain = juce::jlimit(CoefficientTables::minGainInDecibels, CoefficientTables::maxGainInDecibels, gain);
+
+    previousSection = nextSection;
+    nextSection = tables->makePeakSection(processingRate, frequency, Q, gain);
+    currentGain.store((float) gain, std::memory_order_relaxed);
+}
+
+SectionCoefficients DynamicPeak::getStepSection() const noexcept
+{
+    auto t = (double) (stepInControl + 1) / (double) stepsPerControl;
+    SectionCoefficients section;
+
+    for (size_t i = 0; i < section.size(); ++i)
+        section[i] = previousSection[i] + t * (nextSection[i] - previousSection[i]);
+
+    return section;
+}
+
+template <typename SampleType>
+void DynamicPeak::detect(const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    auto numChannels = (int) block.getNumChannels();
+    auto numSamples = (int) block.getNumSamples();
+
+    jassert(numSamples / stepLength + 2 <= (int) steps.size());
+
+    numSteps = 0;
+
+    if (numChannels <= 0 || processingRate <= 0)
+        return;
+
+    auto b0 = bandPass[0], b1 = bandPass[1], b2 = bandPass[2], a1 = bandPass[3], a2 = bandPass[4];
+    auto gain = 1.0 / (numChannels * decimation);   // mix and boxcar average in one
+    auto section = getStepSection();
+
+    for (int start = 0; start < numSamples;)
+    {
+        auto num = juce::jmin(samplesUntilStep, numSamples - start);
+
+        for (int i = start; i < start + num; ++i)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                sum += (double) block.getChannelPointer((size_t) ch)[i];
+
+            if (--samplesUntilDecimated > 0)
+                continue;
+
+            samplesUntilDecimated = decimation;
+
+            auto x = sum * gain;
+            sum = 0;
+
+            // same transposed direct form II as the cascade
+            auto y = x * b0 + s1;
+            s1 = (x * b1) - (y * a1) + s2;
+            s2 = (x * b2) - (y * a2);
+
+            level = juce::jmax(level, std::abs(y));
+        }
+
+        steps[(size_t) numSteps++] = { num, section };
+
+        start += num;
+        samplesUntilStep -= num;
+
+        if (samplesUntilStep == 0)
+        {
+            samplesUntilStep = stepLength;
+
+            if (++stepInControl == stepsPerControl)
+            {
+                stepInControl = 0;
+                updateControl();
+            }
+
+            section = getStepSection();
+        }
+    }
+}
+
+template void DynamicPeak::detect<float>(const juce::dsp::AudioBlock<float>&) noexcept;
+template void DynamicPeak::detect<double>(const juce::dsp::AudioBlock<double>&) noexcept;
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    Dynamic gain for the first peak band, from an envelope follower running
+    at a decimated control rate.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CoefficientDesigner.h"
+#include "CoefficientTables.h"
+#include "ParameterSnapshot.h"
+
+// With "Peak Dynamic" on, the Peak band's gain follows its own band of the input (or of the
+// sidechain bus): above the threshold the gain is pulled down by (level - threshold) * (1 - 1 / ratio) dB,
+// so a boost backs off and a cut digs deeper when the band gets loud.
+//
+// The detector is a mono mix through a band pass at the peak's frequency and Q, and a running
+// peak of it. The band pass runs decimated, at the host rate / D, where D is the largest power
+// of two up to stepLength that still leaves the band below 1/16 of the decimated rate. The mix
+// is summed over D samples on the way in (a boxcar), which droops the band by under 0.06 dB and
+// keeps what folds onto it at least 23 dB down, about what a Q 1 band pass lets through there
+// anyway. So per host sample the detector is only the mix and an add. At 48 kHz a band below
+// 187 Hz runs the band pass every 16 samples, one at 1 kHz every 2, and only bands above
+// 1.5 kHz still need it every sample.
+//
+// Everything else happens once per control period of stepsPerControl * stepLength host samples:
+//
+//  - the peak level goes through attack / release smoothing (in dB, one pole per period)
+//  - the gain is worked out and the peak section redesigned with the tables, no trig
+//  - the section is reached in stepsPerControl linear steps from the previous one, each
+//    stepLength samples long. Biquads whose coefficients lie inside the stability triangle
+//    form a convex set, so a mix of two stable sections is stable too.
+//
+// So a dynamic band costs a mono mix per sample, at most one band pass per sample, a table
+// design every 64 samples and a coefficient swap every 16, instead of a redesign per sample.
+// The gain is one control period behind the level it reacts to.
+//
+// detect() is called with each chunk of host rate input before the chain runs over it, and
+// leaves one Step per stretch of that chunk with the section to use for it.
+class DynamicPeak
+{
+public:
+    static constexpr int stepLength = 16, stepsPerControl = 4;
+
+    struct Step
+    {
+        int numSamples;                 // at the host rate
+        SectionCoefficients section;
+    };
+
+    // preallocates the steps for maximumBlockSize host samples
+    void prepare(double hostSampleRate, int maximumBlockSize);
+    void reset() noexcept;
+
+    void setSettings(const DynamicPeakSettings&) noexcept;
+
+    // the peak's static frequency, Q and gain, and the rate the chain runs at
+    void setCoefficients(const FilterCoefficients&) noexcept;
+
+    // enabled and the Peak band is in the chain
+    bool isActive() const noexcept { return settings.enabled && ! peakBypassed; }
+    bool usesSidechain() const noexcept { return settings.useSidechain; }
+
+    // every channel of block is mixed into the detector, at most the prepared block size
+    template <typename SampleType>
+    void detect(const juce::dsp::AudioBlock<SampleType>& block) noexcept;
+
+    int getNumSteps() const noexcept { return numSteps; }
+    const Step& getStep(int index) const noexcept { return steps[(size_t) index]; }
+
+    // gain the band was last designed with, for display. Any thread.
+    float getCurrentGainInDecibels() const noexcept { return currentGain.load(std::memory_order_relaxed); }
+
+private:
+    void updateControl() noexcept;
+    void updateBandPass() noexcept;
+    SectionCoefficients getStepSection() const noexcept;
+
+    DynamicPeakSettings settings;
+    double hostSampleRate {0}, processingRate {0};
+    double frequency {1000}, Q {1}, staticGain {0};
+    bool peakBypassed {true};
+
+    // detector, the band pass runs at hostSampleRate / decimation
+    SectionCoefficients bandPass {};
+    int decimation {1};
+    double sum {0};                     // of the mix since the last band pass sample
+    int samplesUntilDecimated {1};
+    double s1 {0}, s2 {0};
+    double level {0};                   // peak of the band since the last control point
+    double envelope {-200};             // in dB
+    double attackCoefficient {0}, releaseCoefficient {0};
+    float attackMs {-1}, releaseMs {-1};
+
+    // where we are between control points
+    int samplesUntilStep {stepLength};
+    int stepInControl {0};
+    SectionCoefficients previousSection {}, nextSection {};
+
+    std::vector<Step> steps;
+    int numSteps {0};
+
+    std::atomic<float> currentGain {0};
+
+    juce::SharedResourcePointer<CoefficientTables> tables;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DynamicPeak)
+};
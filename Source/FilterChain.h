@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    Filter chain types and the helpers that design / update them.
+    Shared by the processor, the coefficient designer and the editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+enum Slope
+{
+    Slope_12,
+    Slope_24,
+    Slope_36,
+    Slope_48
+};
+
+// Peak bands: "Peak" (the original one, with the original parameter IDs) plus up to
+// MaxPeakBands - 1 more, of which the first numBands are in use.
+constexpr int MaxPeakBands = 16;
+constexpr int MaxExtraPeakBands = MaxPeakBands - 1;
+
+// the extra peak bands as a table, one array per field
+struct PeakBandTable
+{
+    int numBands {0};
+    std::array<float, MaxExtraPeakBands> freq {}, gainInDecibels {}, q {};
+    std::array<bool, MaxExtraPeakBands> bypassed {};
+};
+
+struct ChainSettings
+{
+    float peakFreq {0},peakGainInDecibels{0}, peakQ {1.0f};
+    float lowCutFreq {0},highCutFreq{0};
+    Slope lowCutSlope {Slope::Slope_12},highCutSlope{Slope::Slope_12};
+    
+    bool lowCutBypassed {false},highCutBypassed {false}, peakBypassed {false};
+    
+    PeakBandTable extraPeaks;
+};
+
+// parameter IDs of peak band `band` (0 .. MaxPeakBands - 1): "Peak Freq" for the first one,
+// then "Peak 2 Freq" and so on
+inline juce::String getPeakParameterID(int band, const juce::String& name)
+{
+    return band == 0 ? "Peak " + name : "Peak " + juce::String(band + 1) + " " + name;
+}
+
+template <typename SampleType>
+using FilterType = juce::dsp::IIR::Filter<SampleType>;
+
+template <typename SampleType>
+using CutFilterType = juce::dsp::ProcessorChain<FilterType<SampleType>,FilterType<SampleType>,
+                                                FilterType<SampleType>,FilterType<SampleType>>;
+
+template <typename SampleType>
+using MonoChainType = juce::dsp::ProcessorChain<CutFilterType<SampleType>,FilterType<SampleType>,CutFilterType<SampleType>>;
+
+using Filter = FilterType<float>;
+using CutFilter = CutFilterType<float>;
+using MonoChain = MonoChainType<float>;
+
+enum ChainPositions
+{
+    LowCut,
+    Peak,
+    HighCut
+};
+
+
+// raw biquad coefficients the way juce stores them: b0, b1, b2, a1, a2 (already divided by a0).
+// Always designed in double, and rounded when loaded into a float chain.
+using SectionCoefficients = std::array<double, 5>;
+
+//note that these are defined here because they need to be defined before use with auto type.
+// they are inline otherwise it will be duplicat symbols.
+// SampleType picks the precision of the design, float unless asked otherwise.
+
+template <typename SampleType = float>
+inline auto makePeakFilter(const ChainSettings& chainSettings, double sampleRate) {
+    return juce::dsp::IIR::Coefficients<SampleType>::makePeakFilter(sampleRate,
+                   static_cast<SampleType>(chainSettings.peakFreq), static_cast<SampleType>(chainSettings.peakQ),
+                   static_cast<SampleType>(juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels)));
+}
+
+template <typename SampleType = float>
+inline auto makeHighCutFilter(const ChainSettings& chainSettings, double sampleRate) {
+    return juce::dsp::FilterDesign<SampleType>::designIIRLowpassHighOrderButterworthMethod(
+                   static_cast<SampleType>(chainSettings.highCutFreq), sampleRate, (chainSettings.highCutSlope+1)*2);
+}
+
+template <typename SampleType = float>
+inline auto makeLowCutFilter(const ChainSettings& chainSettings, double sampleRate) {
+    return juce::dsp::FilterDesign<SampleType>::designIIRHighpassHighOrderButterworthMethod(
+                   static_cast<SampleType>(chainSettings.lowCutFreq), sampleRate,(chainSettings.lowCutSlope+1)*2);
+}
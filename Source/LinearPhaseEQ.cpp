@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+    Linear phase version of the EQ: a symmetric FIR with the chain's magnitude
+    response, run with uniformly partitioned FFT convolution.
+
+  ==============================================================================
+*/
+
+#include "LinearPhaseEQ.h"
+#include "CascadeKernel.h"
+
+LinearPhaseEQ::LinearPhaseEQ(ParameterSnapshot& p) : parameters(p)
+{
+    latencySamples = kernelLength / 2 + partitionSize;
+    tailSamples = latencySamples + kernelLength / 2;
+
+    thread->addTimeSliceClient(this);
+}
+
+LinearPhaseEQ::~LinearPhaseEQ()
+{
+    // waits for a running slice to finish
+    thread->removeTimeSliceClient(this);
+}
+
+void LinearPhaseEQ::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    const juce::ScopedLock sl(kernelLock);
+
+    sampleRate = 0; // keeps the kernel thread out while the engines are rebuilt
+    hasKernel = false;
+    installed = false;
+    convolutions.clear();
+
+    auto numPairs = (spec.numChannels + 1) / 2;
+
+    for (juce::uint32 i = 0; i < numPairs; ++i)
+    {
+        auto* convolution = convolutions.add(new juce::dsp::Convolution(juce::dsp::Convolution::Latency { partitionSize }));
+
+        auto pairSpec = spec;
+        pairSpec.numChannels = juce::jmin((juce::uint32) 2, spec.numChannels - i * 2);
+        convolution->prepare(pairSpec);
+    }
+
+    numChannels = spec.numChannels;
+    silence.setSize((int) juce::jmin((juce::uint32) 2, spec.numChannels), 1);
+    preparedKernelLength = kernelLength;
+
+    // the convolution may round its partition up, ask it rather than assume
+    auto convolutionLatency = convolutions.isEmpty() ? partitionSize : convolutions.getUnchecked(0)->getLatency();
+    latencySamples = preparedKernelLength / 2 + convolutionLatency;
+    tailSamples = latencySamples + preparedKernelLength / 2;
+
+    sampleRate = spec.sampleRate;
+
+    if (parameters.isLinearPhase())
+        loadKernel();
+}
+
+void LinearPhaseEQ::reset() noexcept
+{
+    for (auto* convolution : convolutions)
+        convolution->reset();
+}
+
+bool LinearPhaseEQ::installKernel() noexcept
+{
+    if (installed)
+        return true;
+
+    auto allInstalled = true;
+
+    for (int i = 0; i < convolutions.size(); ++i)
+    {
+        auto* convolution = convolutions.getUnchecked(i);
+
+        if (convolution->getCurrentIRSize() != preparedKernelLength)
+        {
+            silence.clear();
+            juce::dsp::AudioBlock<float> block (silence);
+            auto pair = block.getSubsetChannelBlock(0, juce::jmin((size_t) 2, numChannels - (size_t) i * 2));
+            convolution->process(juce::dsp::ProcessContextReplacing<float>(pair));
+        }
+
+        allInstalled = allInstalled && convolution->getCurrentIRSize() == preparedKernelLength;
+    }
+
+    if (! allInstalled)
+        return false;
+
+    // from juce's placeholder to ours is a crossfade, skip it and the silence we pushed in
+    reset();
+    installed = true;
+    return true;
+}
+
+bool LinearPhaseEQ::waitForKernel(int timeoutMs)
+{
+    auto start = juce::Time::getMillisecondCounter();
+
+    while (! installKernel())
+    {
+        if (juce::Time::getMillisecondCounter() - start > (juce::uint32) timeoutMs)
+            return false;
+
+        juce::Thread::sleep(1);
+    }
+
+    return true;
+}
+
+void LinearPhaseEQ::process(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    for (size_t i = 0; i < (size_t) convolutions.size(); ++i)
+    {
+        auto first = i * 2;
+        auto pair = block.getSubsetChannelBlock(first, juce::jmin((size_t) 2, block.getNumChannels() - first));
+        convolutions.getUnchecked((int) i)->process(juce::dsp::ProcessContextReplacing<float>(pair));
+    }
+}
+
+int LinearPhaseEQ::useTimeSlice()
+{
+    const juce::ScopedLock sl(kernelLock);
+
+    // nothing to do in minimum phase mode. After a switch to linear the processor stays on
+    // the minimum phase chain until installKernel has a kernel from here in every engine.
+    if (sampleRate > 0 && parameters.isLinearPhase() && (! hasKernel || getGenerations() != kernelGenerations))
+        loadKernel();
+
+    return 20; // ms, a new kernel is crossfaded in anyway
+}
+
+LinearPhaseEQ::Generations LinearPhaseEQ::getGenerations() const noexcept
+{
+    return { parameters.getGeneration(LowCut),
+             parameters.getGeneration(Peak),
+             parameters.getGeneration(HighCut) };
+}
+
+void LinearPhaseEQ::loadKernel()
+{
+    // generations first, anything that moves while we work gets picked up next time
+    kernelGenerations = getGenerations();
+    hasKernel = true;
+
+    // at the host rate: the FIR replaces the whole chain, oversampling doesn't apply
+    auto coefficients = designCoefficients(parameters.getChainSettings(), sampleRate);
+
+    juce::AudioBuffer<float> kernel;
+    makeKernel(*coefficients, preparedKernelLength, kernel);
+
+    // every engine takes its own copy, they load and crossfade on juce's own background thread
+    for (auto* convolution : convolutions)
+    {
+        juce::AudioBuffer<float> copy (kernel);
+        convolution->loadImpulseResponse(std::move(copy), sampleRate, juce::dsp::Convolution::Stereo::no,
+                                         juce::dsp::Convolution::Trim::no, juce::dsp::Convolution::Normalise::no);
+    }
+}
+
+void LinearPhaseEQ::makeKernel(const FilterCoefficients& c, int length, juce::AudioBuffer<float>& kernel)
+{
+    jassert(juce::isPowerOfTwo(length));
+
+    CascadeCoefficients cascade;
+    makeCascade(c, cascade);
+
+    // same |H|^2 in terms of phi = sin^2(w/2) as ResponseCurveCache, no cancellation near DC
+    auto magnitudeSquared = [](double c0, double c1, double c2, double phi)
+    {
+        return (c0 + c1 + c2) * (c0 + c1 + c2) - 4.0 * (c0 * c1 + 4.0 * c0 * c2 + c1 * c2) * phi + 16.0 * c0 * c2 * phi * phi;
+    };
+
+    juce::dsp::FFT fft (juce::roundToInt(std::log2(length)));
+    std::vector<float> data ((size_t) length * 2, 0.0f);
+
+    // zero phase spectrum: real magnitudes, no imaginary part
+    for (int bin = 0; bin <= length / 2; ++bin)
+    {
+        auto s = std::sin(juce::MathConstants<double>::pi * bin / length);
+        auto phi = s * s;
+        auto power = 1.0;
+
+        for (int k = 0; k < cascade.numSections; ++k)
+        {
+            const auto& section = cascade.sections[(size_t) k];
+            power *= magnitudeSquared(section[0], section[1], section[2], phi)
+                   / juce::jmax(1.0e-30, magnitudeSquared(1.0, section[3], section[4], phi));
+        }
+
+        data[(size_t) bin * 2] = (float) std::sqrt(juce::jmax(0.0, power));
+    }
+
+    fft.performRealOnlyInverseTransform(data.data());
+
+    // the impulse comes out centred on 0, move it to length / 2 and window it. Blackman over
+    // the whole length is symmetric about the centre and zero at 0, so the FIR is exactly
+    // symmetric and the delay is length / 2.
+    kernel.setSize(1, length);
+    auto* out = kernel.getWritePointer(0);
+    const auto twoPi = juce::MathConstants<double>::twoPi;
+
+    for (int n = 0; n < length; ++n)
+    {
+        auto window = 0.42 - 0.5 * std::cos(twoPi * n / length) + 0.08 * std::cos(2.0 * twoPi * n / length);
+        out[n] = (float) (data[(size_t) ((n + length / 2) % length)] * window);
+    }
+}
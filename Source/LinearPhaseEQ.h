@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    Linear phase version of the EQ: a symmetric FIR with the chain's magnitude
+    response, run with uniformly partitioned FFT convolution.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CoefficientDesigner.h"
+
+// While Phase Mode is Linear, a kernel thread polls the band generations like the designer
+// does (in Minimum phase mode it does nothing). When something moved it designs the chain at the host rate, samples |H| on an FFT grid, inverse transforms it
+// (zero phase), centres it and windows it into a symmetric FIR, and hands that to
+// juce::dsp::Convolution. The convolution crossfades from the old kernel to the new one
+// by itself, so parameter changes don't click.
+//
+// Latency is kernelLength / 2 for the FIR plus the partition size of the convolution.
+// Longer kernels resolve low cuts better, bigger partitions are cheaper but later.
+//
+// juce::dsp::Convolution handles at most two channels, so channels go in pairs.
+class LinearPhaseEQ : private juce::TimeSliceClient
+{
+public:
+    explicit LinearPhaseEQ(ParameterSnapshot& parameters);
+    ~LinearPhaseEQ() override;
+
+    // powers of two. Take effect on the next prepare.
+    void setKernelLength(int numSamples) noexcept { kernelLength = juce::nextPowerOfTwo(juce::jlimit(256, 65536, numSamples)); }
+    void setPartitionSize(int numSamples) noexcept { partitionSize = juce::nextPowerOfTwo(juce::jlimit(64, 16384, numSamples)); }
+
+    // builds the engines (in either mode, so a switch to linear doesn't allocate) and in linear
+    // phase mode designs the first kernel. Doesn't wait for juce to load it. Not the audio thread.
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset() noexcept;
+
+    // juce::dsp::Convolution loads a kernel on its own thread and only swaps it in from process(),
+    // crossfading from what it had, which after prepare is a placeholder with no EQ at all. This
+    // pushes a sample of silence through every engine that doesn't have a kernel of ours yet, and
+    // once they all have, resets them so the crossfade is over. Until it returns true the caller
+    // should carry on with the minimum phase chain. Audio thread, cheap once true.
+    bool installKernel() noexcept;
+
+    // for offline use: calls installKernel until it's done, so the first block doesn't depend on
+    // the threads. False if juce's loader didn't get there in time. Not while process() can run.
+    bool waitForKernel(int timeoutMs);
+
+    // float only, like juce::dsp::Convolution
+    void process(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    // worked out in prepare, so any thread can ask while the engines are being rebuilt
+    int getLatencySamples() const noexcept { return latencySamples.load(); }
+
+    // how long the output carries on after the input stops: the whole kernel plus the partition
+    int getTailSamples() const noexcept { return tailSamples.load(); }
+
+    // |H| of c sampled at kernelLength bins, turned into a windowed, centred symmetric FIR
+    static void makeKernel(const FilterCoefficients& c, int kernelLength, juce::AudioBuffer<float>& kernel);
+
+private:
+    using Generations = std::array<juce::uint32, 3>;
+
+    int useTimeSlice() override;
+
+    Generations getGenerations() const noexcept;
+    void loadKernel();
+
+    struct KernelThread : juce::TimeSliceThread
+    {
+        KernelThread() : juce::TimeSliceThread("SimpleEQ kernels") { startThread(); }
+        ~KernelThread() override { stopThread(1000); }
+    };
+
+    ParameterSnapshot& parameters;
+
+    int kernelLength {8192}, partitionSize {512};
+    int preparedKernelLength {8192};                    // what the engines were prepared with
+
+    juce::CriticalSection kernelLock;                   // kernel thread vs prepare
+    std::atomic<double> sampleRate {0};
+    Generations kernelGenerations {};
+    bool hasKernel {false};                             // since the last prepare
+
+    std::atomic<int> latencySamples {0}, tailSamples {0};
+
+    juce::OwnedArray<juce::dsp::Convolution> convolutions;   // one per channel pair
+    size_t numChannels {0};
+    juce::AudioBuffer<float> silence;                   // for installKernel, one sample
+    bool installed {false};                             // audio thread
+
+    juce::SharedResourcePointer<KernelThread> thread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LinearPhaseEQ)
+};
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    How much of each block's time budget processBlock uses.
+
+  ==============================================================================
+*/
+
+#include "LoadMeter.h"
+
+// the average is smoothed over roughly this long
+static constexpr double averagingTimeSeconds = 1.0;
+
+LoadMeter::LoadMeter()
+    : ticksPerSecond((double) juce::Time::getHighResolutionTicksPerSecond())
+{
+    clear();
+}
+
+void LoadMeter::prepare(double newSampleRate) noexcept
+{
+    sampleRate = newSampleRate;
+    reset();
+}
+
+// only ever runs on the audio thread (or before it starts), so plain stores are enough
+void LoadMeter::clear() noexcept
+{
+    currentLoad = 0;
+    averageLoad = 0;
+    worstLoad = 0;
+    numBlocks = 0;
+    numDeadlineMisses = 0;
+
+    for (auto& bin : histogram)
+        bin = 0;
+
+    for (auto& w : worstLoadBySections)
+        w = 0;
+}
+
+void LoadMeter::addBlock(juce::int64 startTicks, int numSamples, int numSections) noexcept
+{
+    auto elapsedTicks = now() - startTicks;
+
+    if(numSamples <= 0)
+        return;
+
+    constexpr auto relaxed = std::memory_order_relaxed;
+
+    // a load and, only after a reset, a store. An exchange would be a locked RMW every block.
+    if(resetRequested.load(relaxed))
+    {
+        resetRequested.store(false, relaxed);
+        clear();
+    }
+
+    auto blockSeconds = numSamples / sampleRate.load(relaxed);
+    auto load = (float) ((double) elapsedTicks / ticksPerSecond / blockSeconds);
+
+    currentLoad.store(load, relaxed);
+
+    // one pole average, weighted by block length so it's the same at any block size
+    auto alpha = (float) (blockSeconds / (blockSeconds + averagingTimeSeconds));
+    auto average = averageLoad.load(relaxed);
+    averageLoad.store(average + alpha * (load - average), relaxed);
+
+    if(load > worstLoad.load(relaxed))
+        worstLoad.store(load, relaxed);
+
+    auto sections = (size_t) juce::jlimit(0, (int) NumCascadeSlots, numSections);
+
+    if(load > worstLoadBySections[sections].load(relaxed))
+        worstLoadBySections[sections].store(load, relaxed);
+
+    auto bin = (size_t) juce::jlimit(0, LoadStatistics::numHistogramBins - 1, (int) (load * 20.0f));
+    histogram[bin].store(histogram[bin].load(relaxed) + 1, relaxed);
+
+    if(load >= 1.0f)
+        numDeadlineMisses.store(numDeadlineMisses.load(relaxed) + 1, relaxed);
+
+    numBlocks.store(numBlocks.load(relaxed) + 1, relaxed);
+}
+
+LoadStatistics LoadMeter::getStatistics() const noexcept
+{
+    LoadStatistics s;
+
+    s.currentLoad = currentLoad.load();
+    s.averageLoad = averageLoad.load();
+    s.worstLoad = worstLoad.load();
+    s.numBlocks = numBlocks.load();
+    s.numDeadlineMisses = numDeadlineMisses.load();
+
+    for (size_t i = 0; i < histogram.size(); ++i)
+        s.histogram[i] = histogram[i].load();
+
+    for (size_t i = 0; i < worstLoadBySections.size(); ++i)
+        s.worstLoadBySections[i] = worstLoadBySections[i].load();
+
+    return s;
+}
@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    How much of each block's time budget processBlock uses.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CascadeKernel.h"
+
+// Load is the time spent in processBlock divided by the block's duration, so 1.0 means
+// the block took as long as the audio it produced and the deadline was missed.
+//
+// The audio thread is the only writer: it reads the high resolution tick counter twice per
+// block and does a handful of relaxed atomic stores, no locks and no RMW instructions.
+// Any thread can read the figures; they're individually consistent, not as a set.
+struct LoadStatistics
+{
+    static constexpr int numHistogramBins = 21; // 5% each, the last one is >= 100% (a miss)
+
+    float currentLoad {0}, averageLoad {0}, worstLoad {0};
+    juce::uint64 numBlocks {0}, numDeadlineMisses {0};
+    std::array<juce::uint32, numHistogramBins> histogram {};
+
+    // worst load seen with n active biquad sections, so heavy slope settings stand out
+    std::array<float, NumCascadeSlots + 1> worstLoadBySections {};
+};
+
+class LoadMeter
+{
+public:
+    LoadMeter();
+
+    void prepare(double sampleRate) noexcept;
+
+    // clears the figures. Safe from any thread, the audio thread does it on its next block.
+    void reset() noexcept { resetRequested = true; }
+
+    static juce::int64 now() noexcept { return juce::Time::getHighResolutionTicks(); }
+
+    // audio thread: call with the ticks from now() taken at the start of the block
+    void addBlock(juce::int64 startTicks, int numSamples, int numSections) noexcept;
+
+    LoadStatistics getStatistics() const noexcept;
+
+private:
+    void clear() noexcept;
+
+    double ticksPerSecond;
+    std::atomic<double> sampleRate {44100.0};
+
+    std::atomic<float> currentLoad {0}, averageLoad {0}, worstLoad {0};
+    std::atomic<juce::uint64> numBlocks {0}, numDeadlineMisses {0};
+    std::array<std::atomic<juce::uint32>, LoadStatistics::numHistogramBins> histogram;
+    std::array<std::atomic<float>, NumCascadeSlots + 1> worstLoadBySections;
+
+    std::atomic<bool> resetRequested {false};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoadMeter)
+};
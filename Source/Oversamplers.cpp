@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    Optional 2x / 4x / 8x oversampling around the filter cascade.
+
+  ==============================================================================
+*/
+
+#include "Oversamplers.h"
+
+template <typename SampleType>
+void Oversamplers<SampleType>::prepare(size_t numChannels, size_t maximumBlockSize)
+{
+    using Oversampling = juce::dsp::Oversampling<SampleType>;
+
+    for (size_t i = 0; i < stages.size(); ++i)
+    {
+        // the constructor takes the number of 2x stages: 1 -> 2x, 2 -> 4x, 3 -> 8x
+        stages[i] = std::make_unique<Oversampling>(numChannels, i + 1, Oversampling::filterHalfBandPolyphaseIIR,
+                                                   true, true);
+        stages[i]->initProcessing(maximumBlockSize);
+    }
+}
+
+template <typename SampleType>
+void Oversamplers<SampleType>::reset() noexcept
+{
+    for (auto& stage : stages)
+        if(stage != nullptr)
+            stage->reset();
+}
+
+template <typename SampleType>
+size_t Oversamplers<SampleType>::getIndex(int factor) noexcept
+{
+    jassert(factor == 2 || factor == 4 || factor == 8);
+    return factor >= 8 ? 2 : (factor >= 4 ? 1 : 0);
+}
+
+template <typename SampleType>
+juce::dsp::Oversampling<SampleType>* Oversamplers<SampleType>::get(int factor) noexcept
+{
+    if(factor <= 1)
+        return nullptr;
+
+    return stages[getIndex(factor)].get();
+}
+
+template <typename SampleType>
+int Oversamplers<SampleType>::getLatencySamples(int factor) noexcept
+{
+    auto* stage = get(factor);
+    return stage != nullptr ? juce::roundToInt(stage->getLatencyInSamples()) : 0;
+}
+
+template class Oversamplers<float>;
+template class Oversamplers<double>;
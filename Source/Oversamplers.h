@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+
+    Optional 2x / 4x / 8x oversampling around the filter cascade.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// One juce::dsp::Oversampling per factor, all prepared up front so switching factor on
+// the audio thread never allocates. Polyphase IIR halfbands (max quality) with integer
+// latency, so the latency reported to the host is exact.
+template <typename SampleType>
+class Oversamplers
+{
+public:
+    static constexpr int maxFactor = 8;
+
+    void prepare(size_t numChannels, size_t maximumBlockSize);
+    void reset() noexcept;
+
+    // nullptr for a factor of 1
+    juce::dsp::Oversampling<SampleType>* get(int factor) noexcept;
+
+    // in samples at the host rate, 0 before prepare
+    int getLatencySamples(int factor) noexcept;
+
+private:
+    static size_t getIndex(int factor) noexcept;
+
+    std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, 3> stages;  // 2x, 4x, 8x
+};
+
+// "Oversampling" choice index -> factor
+inline int getOversamplingFactorForChoice(float choice) noexcept
+{
+    return 1 << juce::jlimit(0, 3, (int) choice);
+}
@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    Cached view of the EQ parameters with a change counter per band.
+
+  ==============================================================================
+*/
+
+#include "ParameterSnapshot.h"
+
+static int getBandForParameter(const juce::String& paramID)
+{
+    // the dynamic settings are read per block, no redesign needed
+    if (paramID == "Peak Dynamic" || paramID == "Peak Sidechain" || paramID == "Peak Threshold"
+         || paramID == "Peak Ratio" || paramID == "Peak Attack" || paramID == "Peak Release")
+        return -1;
+
+    if (paramID.startsWith("LowCut"))
+        return LowCut;
+    if (paramID.startsWith("Peak"))
+        return Peak;
+    if (paramID.startsWith("HighCut"))
+        return HighCut;
+
+    return -1;
+}
+
+ParameterSnapshot::ParameterSnapshot(juce::AudioProcessorValueTreeState& s) : apvts(s)
+{
+    lowCutFreq      = apvts.getRawParameterValue("LowCut Freq");
+    highCutFreq     = apvts.getRawParameterValue("HighCut Freq");
+    lowCutSlope     = apvts.getRawParameterValue("LowCut Slope");
+    highCutSlope    = apvts.getRawParameterValue("HighCut Slope");
+    peakFreq        = apvts.getRawParameterValue("Peak Freq");
+    peakQ           = apvts.getRawParameterValue("Peak Q");
+    peakGain        = apvts.getRawParameterValue("Peak Gain");
+    lowCutBypassed  = apvts.getRawParameterValue("LowCut Bypassed");
+    peakBypassed    = apvts.getRawParameterValue("Peak Bypassed");
+    highCutBypassed = apvts.getRawParameterValue("HighCut Bypassed");
+    oversampling    = apvts.getRawParameterValue("Oversampling");
+    phaseMode       = apvts.getRawParameterValue("Phase Mode");
+    numPeakBands    = apvts.getRawParameterValue("Peak Bands");
+    peakDynamic     = apvts.getRawParameterValue("Peak Dynamic");
+    peakSidechain   = apvts.getRawParameterValue("Peak Sidechain");
+    peakThreshold   = apvts.getRawParameterValue("Peak Threshold");
+    peakRatio       = apvts.getRawParameterValue("Peak Ratio");
+    peakAttack      = apvts.getRawParameterValue("Peak Attack");
+    peakRelease     = apvts.getRawParameterValue("Peak Release");
+
+    for (int i = 0; i < MaxExtraPeakBands; ++i)
+    {
+        extraPeakFreq[(size_t) i]     = apvts.getRawParameterValue(getPeakParameterID(i + 1, "Freq"));
+        extraPeakGain[(size_t) i]     = apvts.getRawParameterValue(getPeakParameterID(i + 1, "Gain"));
+        extraPeakQ[(size_t) i]        = apvts.getRawParameterValue(getPeakParameterID(i + 1, "Q"));
+        extraPeakBypassed[(size_t) i] = apvts.getRawParameterValue(getPeakParameterID(i + 1, "Bypassed"));
+    }
+
+    for (auto* param : apvts.processor.getParameters())
+        if (auto* rap = dynamic_cast<juce::RangedAudioParameter*>(param))
+        {
+            auto band = getBandForParameter(rap->paramID);
+
+            if (band >= 0)
+                apvts.addParameterListener(rap->paramID, &bands[(size_t) band]);
+        }
+
+    apvts.addParameterListener("Oversampling", &oversamplingListener);
+}
+
+ParameterSnapshot::~ParameterSnapshot()
+{
+    for (auto* param : apvts.processor.getParameters())
+        if (auto* rap = dynamic_cast<juce::RangedAudioParameter*>(param))
+        {
+            auto band = getBandForParameter(rap->paramID);
+
+            if (band >= 0)
+                apvts.removeParameterListener(rap->paramID, &bands[(size_t) band]);
+        }
+
+    apvts.removeParameterListener("Oversampling", &oversamplingListener);
+}
+
+ChainSettings ParameterSnapshot::getChainSettings() const noexcept
+{
+    ChainSettings chain;
+
+    chain.lowCutFreq = lowCutFreq->load();
+    chain.highCutFreq = highCutFreq->load();
+    chain.lowCutSlope = static_cast<Slope> (lowCutSlope->load());
+    chain.highCutSlope = static_cast<Slope> (highCutSlope->load());
+    chain.peakFreq = peakFreq->load();
+    chain.peakQ = peakQ->load();
+    chain.peakGainInDecibels = peakGain->load();
+
+    chain.lowCutBypassed = lowCutBypassed->load() > 0.5f;
+    chain.peakBypassed = peakBypassed->load() > 0.5f;
+    chain.highCutBypassed = highCutBypassed->load() > 0.5f;
+
+    // only the bands in use, the rest of the table is never looked at
+    auto& extra = chain.extraPeaks;
+    extra.numBands = juce::jlimit(0, MaxExtraPeakBands, (int) numPeakBands->load());
+
+    for (size_t i = 0; i < (size_t) extra.numBands; ++i)
+    {
+        extra.freq[i] = extraPeakFreq[i]->load();
+        extra.gainInDecibels[i] = extraPeakGain[i]->load();
+        extra.q[i] = extraPeakQ[i]->load();
+        extra.bypassed[i] = extraPeakBypassed[i]->load() > 0.5f;
+    }
+
+    return chain;
+}
+
+DynamicPeakSettings ParameterSnapshot::getDynamicPeakSettings() const noexcept
+{
+    DynamicPeakSettings dynamic;
+
+    dynamic.enabled = peakDynamic->load() > 0.5f;
+    dynamic.useSidechain = peakSidechain->load() > 0.5f;
+    dynamic.thresholdInDecibels = peakThreshold->load();
+    dynamic.ratio = peakRatio->load();
+    dynamic.attackMs = peakAttack->load();
+    dynamic.releaseMs = peakRelease->load();
+    return dynamic;
+}
+
+void ParameterSnapshot::invalidateAll() noexcept
+{
+    for (auto& band : bands)
+        ++band.generation;
+}
@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    Cached view of the EQ parameters with a change counter per band.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+#include "Oversamplers.h"
+
+// dynamic mode of the first peak band, see DynamicPeak.h
+struct DynamicPeakSettings
+{
+    bool enabled {false}, useSidechain {false};
+    float thresholdInDecibels {-24.0f}, ratio {2.0f};
+    float attackMs {10.0f}, releaseMs {100.0f};
+};
+
+// Looks the parameters up once, so reading them back is a handful of atomic loads
+// instead of string lookups. Every band (LowCut, Peak, HighCut) gets a generation
+// counter that is bumped whenever one of its parameters changes, so consumers can tell
+// which band needs redesigning without comparing settings. The extra peak bands and the
+// band count all count as Peak.
+class ParameterSnapshot
+{
+public:
+    explicit ParameterSnapshot(juce::AudioProcessorValueTreeState& apvts);
+    ~ParameterSnapshot();
+
+    // safe from any thread
+    ChainSettings getChainSettings() const noexcept;
+
+    juce::uint32 getGeneration(ChainPositions band) const noexcept { return bands[band].generation.load(); }
+
+    // 1, 2, 4 or 8. A change counts as a change to every band, they all need designing at the new rate.
+    int getOversamplingFactor() const noexcept { return getOversamplingFactorForChoice(oversampling->load()); }
+
+    bool isLinearPhase() const noexcept { return phaseMode->load() > 0.5f; }
+
+    // these don't count as a Peak change, the peak's static design doesn't depend on them
+    DynamicPeakSettings getDynamicPeakSettings() const noexcept;
+
+    // mark all bands as changed, e.g. after the whole state was replaced
+    void invalidateAll() noexcept;
+
+private:
+    // one listener per band, so the callback (which may run on the audio thread during
+    // automation) doesn't have to look at the parameter ID. The apvts calls these after
+    // the raw value has been stored, so a new generation always comes with the new value.
+    struct Band : juce::AudioProcessorValueTreeState::Listener
+    {
+        void parameterChanged(const juce::String&, float) override { ++generation; }
+
+        std::atomic<juce::uint32> generation {0};
+    };
+
+    struct AllBands : juce::AudioProcessorValueTreeState::Listener
+    {
+        explicit AllBands(ParameterSnapshot& o) : owner(o) {}
+        void parameterChanged(const juce::String&, float) override { owner.invalidateAll(); }
+
+        ParameterSnapshot& owner;
+    };
+
+    juce::AudioProcessorValueTreeState& apvts;
+
+    std::atomic<float>* lowCutFreq {nullptr};
+    std::atomic<float>* highCutFreq {nullptr};
+    std::atomic<float>* lowCutSlope {nullptr};
+    std::atomic<float>* highCutSlope {nullptr};
+    std::atomic<float>* peakFreq {nullptr};
+    std::atomic<float>* peakQ {nullptr};
+    std::atomic<float>* peakGain {nullptr};
+    std::atomic<float>* lowCutBypassed {nullptr};
+    std::atomic<float>* peakBypassed {nullptr};
+    std::atomic<float>* highCutBypassed {nullptr};
+    std::atomic<float>* oversampling {nullptr};
+    std::atomic<float>* phaseMode {nullptr};
+
+    std::atomic<float>* peakDynamic {nullptr};
+    std::atomic<float>* peakSidechain {nullptr};
+    std::atomic<float>* peakThreshold {nullptr};
+    std::atomic<float>* peakRatio {nullptr};
+    std::atomic<float>* peakAttack {nullptr};
+    std::atomic<float>* peakRelease {nullptr};
+
+    // the extra peak bands, indexed like PeakBandTable
+    std::atomic<float>* numPeakBands {nullptr};
+    std::array<std::atomic<float>*, MaxExtraPeakBands> extraPeakFreq {}, extraPeakGain {}, extraPeakQ {}, extraPeakBypassed {};
+
+    std::array<Band, 3> bands;  // indexed by ChainPositions
+    AllBands oversamplingListener {*this};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterSnapshot)
+};
@@ -201,14 +201,16 @@ juce::String RotarySliderWithLabels::getDisplayString() const{
 }
 //=====================================================================
 
-ResponseCurveComponent::ResponseCurveComponent(SimpleEQAudioProcessor &p): audioProcessor(p)
+ResponseCurveComponent::ResponseCurveComponent(SimpleEQAudioProcessor &p): audioProcessor(p),
+curveWorker(p.getCoefficientDesigner()),
+analyzer(p, p.getAnalyzerFifo(false), p.getAnalyzerFifo(true))
 {
-    const auto& params = audioProcessor.getParameters();
-    for(auto param : params){
-        param->addListener(this);
-    }
+    // no parameter listeners: the curve worker polls the designer's generation
+    audioProcessor.addAnalyzerUser();
+    
+    // the grid layer covers everything, nothing behind us needs painting
+    setOpaque(true);
     
-    updateChain();
     startTimerHz(60);
   
     
@@ -216,144 +218,142 @@ ResponseCurveComponent::ResponseCurveComponent(SimpleEQAudioProcessor &p): audio
 
 ResponseCurveComponent::~ResponseCurveComponent() {
     
-    const auto& params = audioProcessor.getParameters();
-    for(auto param : params){
-        param->removeListener(this);
-    }
-    
-}
-
-
-void ResponseCurveComponent::parameterValueChanged(int parameterIndex, float newValue) {
-    
-    parametersChanged.set(true);
+    audioProcessor.removeAnalyzerUser();
 }
 
 void ResponseCurveComponent::timerCallback(){
-    if(parametersChanged.compareAndSetBool(false, true)) {
-        //update GUI filter
-        updateChain();
-        //redraw
-        repaint();
+    auto needsRepaint = false;
+    
+    // new curve from the worker?
+    auto generation = curveWorker.getGeneration();
+    if(generation != curveGeneration) {
+        curveGeneration = generation;
+        curve = curveWorker.getSnapshot();
+        curveLayer.valid = false;
+        needsRepaint = true;
     }
-}
-
-void ResponseCurveComponent::updateChain(){
-    //update GUI filter chain
-    auto chainSettings = getChainSettings(audioProcessor.apvts);
-    
-    monoChain.setBypassed<Peak>(chainSettings.peakBypassed);
-    monoChain.setBypassed<LowCut>(chainSettings.lowCutBypassed);
-    monoChain.setBypassed<HighCut>(chainSettings.highCutBypassed);
-    
-    auto sampleRate = audioProcessor.getSampleRate();
-    auto peakCoef = makePeakFilter(chainSettings, sampleRate);
-    updateCoefficients(monoChain.get<ChainPositions::Peak>().coefficients,peakCoef);
     
-    auto lowCutCoef = makeLowCutFilter(chainSettings, sampleRate);
-    auto highCutCoef = makeHighCutFilter(chainSettings, sampleRate);
-    updateCutFilter(monoChain.get<ChainPositions::HighCut>(), highCutCoef, chainSettings.highCutSlope,sampleRate);
-    updateCutFilter(monoChain.get<ChainPositions::LowCut>(), lowCutCoef, chainSettings.lowCutSlope,sampleRate);
-
-   
+    // new spectrum from the analyzer thread?
+    generation = analyzer.getGeneration();
+    if(generation != analyzerGeneration) {
+        analyzerGeneration = generation;
+        analyzer.fetchPaths(preEqSpectrum, postEqSpectrum);
+        spectrumLayer.valid = false;
+        needsRepaint = true;
+    }
     
+    if(needsRepaint)
+        //redraw, only the curve / spectrum area, the labels around it don't change
+        repaint(getRenderArea());
 }
 
 void ResponseCurveComponent::paint(juce::Graphics &g){
     using namespace juce;
-    // (Our component is opaque, so we must completely fill the background with a solid colour)
-    g.fillAll (Colours::black);
-    auto responseArea = getAnalysisArea();
-    
-    
-    auto w = responseArea.getWidth();
-    
-    auto& lowcut = monoChain.get<ChainPositions::LowCut>();
-    auto& peak = monoChain.get<ChainPositions::Peak>();
-    auto& highcut = monoChain.get<ChainPositions::HighCut>();
-    
-    auto sampleRate = audioProcessor.getSampleRate();
-    
-    std::vector<double> mags; // width of the region
-    
-    mags.resize(w);
-    
-    for(int i=0; i<w; ++i)
-    {
-        double mag =1.f;
-        auto freq = mapToLog10(double(i) / double(w), 20.0, 20000.0);
-        
-       
-        if(!monoChain.isBypassed<ChainPositions::Peak>())
-            mag *= peak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        
-        
-        if(!monoChain.isBypassed<HighCut>()) {
-            if(!highcut.isBypassed<0>())
-                mag *= highcut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            
-            if(!highcut.isBypassed<1>())
-                mag *= highcut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            
-            if(!highcut.isBypassed<2>())
-                mag *= highcut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            
-            if(!highcut.isBypassed<3>())
-                mag *= highcut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
+    auto start = Time::getHighResolutionTicks();
+    
+    if(layerCacheEnabled) {
+        // layers are kept at the physical resolution, so they're sharp on retina / 4K and
+        // drawn 1:1. Moving to a screen with a different scale invalidates them all.
+        auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        if(scale != layerScale) {
+            layerScale = scale;
+            invalidateLayers();
         }
         
-        if(!monoChain.isBypassed<LowCut>()) {
-            if(!lowcut.isBypassed<0>())
-                mag *= lowcut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            
-            if(!lowcut.isBypassed<1>())
-                mag *= lowcut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            
-            if(!lowcut.isBypassed<2>())
-                mag *= lowcut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            
-            if(!lowcut.isBypassed<3>())
-                mag *= lowcut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        }
-        mags[i] = Decibels::gainToDecibels(mag);
+        updateLayer(gridLayer, true, [this](Graphics& lg){ drawGrid(lg); });
+        updateLayer(spectrumLayer, false, [this](Graphics& lg){ drawSpectrum(lg); });
+        updateLayer(curveLayer, false, [this](Graphics& lg){ drawCurve(lg); });
+        
+        auto bounds = getLocalBounds().toFloat();
+        g.drawImage(gridLayer.image, bounds);
+        g.drawImage(spectrumLayer.image, bounds);
+        g.drawImage(curveLayer.image, bounds);
+    } else {
+        // everything straight into the context, every frame. Kept for comparing paint times.
+        drawGrid(g);
+        drawSpectrum(g);
+        drawCurve(g);
     }
     
+    auto ms = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) * 1000.0;
+    averagePaintMs += 0.05 * (ms - averagePaintMs);
+    worstPaintMs = jmax(worstPaintMs, ms);
+}
+
+void ResponseCurveComponent::setLayerCacheEnabled(bool shouldBeEnabled){
+    layerCacheEnabled = shouldBeEnabled;
+    invalidateLayers();
+    resetPaintTimes();
+    repaint();
+}
+
+void ResponseCurveComponent::resetPaintTimes(){
+    averagePaintMs = 0;
+    worstPaintMs = 0;
+}
+
+void ResponseCurveComponent::invalidateLayers(){
+    gridLayer.valid = false;
+    spectrumLayer.valid = false;
+    curveLayer.valid = false;
+}
+
+void ResponseCurveComponent::updateLayer(Layer& layer, bool opaque, const std::function<void(juce::Graphics&)>& draw){
+    using namespace juce;
+    if(layer.valid)
+        return;
     
-    // draw background image
-    
-    g.drawImage(background,  getLocalBounds().toFloat());
-    // Draw curve
-    Path responseCurve;
+    auto w = roundToInt(getWidth() * layerScale);
+    auto h = roundToInt(getHeight() * layerScale);
     
-    const double outputMin = responseArea.getBottom();
-    const double outputMax = responseArea.getY();
+    if(w <= 0 || h <= 0)
+        return;
     
-    auto map = [outputMin,outputMax](double input){
-        return jmap(input,-24.0,24.0,outputMin,outputMax);
-    };
+    // reuse the image when the size is the same, just clear it
+    if(layer.image.getWidth() != w || layer.image.getHeight() != h)
+        layer.image = Image(opaque ? Image::RGB : Image::ARGB, w, h, true);
+    else if(! opaque)
+        layer.image.clear(layer.image.getBounds());
     
-    responseCurve.startNewSubPath(responseArea.getX(),map(mags.front()));
+    Graphics lg{layer.image};
+    lg.addTransform(AffineTransform::scale(layerScale));
+    draw(lg);
     
-    for(size_t i=1;i< mags.size();++i) {
-        responseCurve.lineTo(responseArea.getX()+i,map(mags[i]));
+    layer.valid = true;
+}
+
+void ResponseCurveComponent::drawSpectrum(juce::Graphics &g){
+    using namespace juce;
+    // spectrum behind the curve, input dim, output brighter
+    g.setColour(Colours::skyblue.withAlpha(0.35f));
+    g.strokePath(preEqSpectrum, PathStrokeType(1.0f));
+    g.setColour(Colours::skyblue);
+    g.strokePath(postEqSpectrum, PathStrokeType(1.0f));
+}
+
+void ResponseCurveComponent::drawCurve(juce::Graphics &g){
+    using namespace juce;
+    // curve comes ready made from the worker
+    if(curve != nullptr) {
+        g.setColour(Colours::white);
+        g.strokePath(curve->path, PathStrokeType(2.0f));
     }
-    
-    g.setColour(Colours::orange);
-    // rectangle around render area, which is slightly bigger then response area.
-    g.drawRoundedRectangle(getRenderArea().toFloat(), 4.f, 1.f);
-    g.setColour(Colours::white);
-    g.strokePath(responseCurve, PathStrokeType(2.0f));
-    
+}
 
+void ResponseCurveComponent::resized(){
+    // the analyzer builds its paths for this area, on the -48..0 dB scale drawn on the left
+    analyzer.setArea(getAnalysisArea().toFloat());
+    curveWorker.setArea(getAnalysisArea());
     
+    // everything changes size, the grid gets redrawn on the next paint and only then
+    invalidateLayers();
 }
 
-void ResponseCurveComponent::resized(){
+void ResponseCurveComponent::drawGrid(juce::Graphics& g){
     using namespace juce;
+    // (Our component is opaque, so we must completely fill the background with a solid colour)
+    g.fillAll (Colours::black);
     
-    background = Image(Image::PixelFormat::RGB,getWidth(),getHeight(),true);
-    
-    Graphics g{background};
     // Commented out frequencies were colliding.
     Array<float> freqs{
         20,/* 30,40,*/ 50,100,200,
@@ -459,7 +459,7 @@ void ResponseCurveComponent::resized(){
         g.setColour( gdB == 0.0 ? Colour(0u,172u,1u) : Colours::lightgrey);
         g.drawFittedText(str,r,juce::Justification::centred,1);
         
-        // We also need to put in scale for spectrum analizer
+        // and the scale for the spectrum analyzer, SpectrumAnalyzer::minDecibels..maxDecibels
         
         str.clear();
         str << (gdB-24.f);
@@ -473,7 +473,9 @@ void ResponseCurveComponent::resized(){
         g.drawFittedText(str,r,juce::Justification::centred,1);
     }
     
-    
+    g.setColour(Colours::orange);
+    // rectangle around render area, which is slightly bigger then response area.
+    g.drawRoundedRectangle(getRenderArea().toFloat(), 4.f, 1.f);
 }
 
 juce::Rectangle<int> ResponseCurveComponent::getRenderArea(){
@@ -497,6 +499,62 @@ juce::Rectangle<int> ResponseCurveComponent::getAnalysisArea(){
 }
 
 
+//=====================================================================
+
+LoadMeterComponent::LoadMeterComponent(SimpleEQAudioProcessor &p, ResponseCurveComponent& rcc): audioProcessor(p),
+responseCurve(rcc)
+{
+    // a few times a second is plenty for numbers
+    startTimerHz(4);
+}
+
+void LoadMeterComponent::timerCallback(){
+    statistics = audioProcessor.getLoadStatistics();
+    repaint();
+}
+
+void LoadMeterComponent::paint(juce::Graphics &g){
+    using namespace juce;
+    
+    String str;
+    str << "CPU " << String(statistics.averageLoad * 100.0f, 1) << "%"
+        << "  max " << String(statistics.worstLoad * 100.0f, 1) << "%";
+    
+    if(statistics.numDeadlineMisses > 0)
+        str << "  misses " << (int64) statistics.numDeadlineMisses;
+    
+    // how often a cut design came out of the shared cache, over every instance
+    auto cache = audioProcessor.getCoefficientCacheStatistics();
+    
+    if(cache.hits + cache.misses > 0)
+        str << "  cache " << String(cache.getHitRate() * 100.0, 0) << "%";
+    
+    // and the GUI side: what a response curve frame costs on the message thread
+    str << "  paint " << String(responseCurve.getAveragePaintMs(), 2) << " ms";
+    
+    if(! responseCurve.isLayerCacheEnabled())
+        str << " (direct)";
+    
+    g.setColour(Colours::black.withAlpha(0.6f));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 3.f);
+    
+    g.setColour(statistics.numDeadlineMisses > 0 ? Colours::red : Colours::lightgrey);
+    g.setFont(10);
+    g.drawFittedText(str, getLocalBounds(), Justification::centred, 1);
+}
+
+void LoadMeterComponent::mouseDown(const juce::MouseEvent& e){
+    // shift click flips the response curve between layered and direct painting, to compare
+    if(e.mods.isShiftDown()) {
+        responseCurve.setLayerCacheEnabled(! responseCurve.isLayerCacheEnabled());
+        return;
+    }
+    
+    audioProcessor.resetLoadStatistics();
+    responseCurve.resetPaintTimes();
+}
+
+
 //==============================================================================
 
 //===  SimpleEQAudioProcessorEditor
@@ -511,16 +569,13 @@ highCutFreqSlider(*audioProcessor.apvts.getParameter("HighCut Freq"), "Hz"),
 lowCutSlopeSlider(*audioProcessor.apvts.getParameter("LowCut Slope"),"dB/Oct"),
 highCutSlopeSlider(*audioProcessor.apvts.getParameter("HighCut Slope"),"dB/Oct"),
 responseCurveComponent(audioProcessor),
-peakFreqSliderAttachment(audioProcessor.apvts,"Peak Freq",peakFreqSlider),
-peakGainSliderAttachment(audioProcessor.apvts,"Peak Gain",peakGainSlider),
-peakQualitySliderAttachment(audioProcessor.apvts,"Peak Q",peakQualitySlider),
+loadMeterComponent(audioProcessor, responseCurveComponent),
 lowCutFreqSliderAttachment(audioProcessor.apvts,"LowCut Freq",lowCutFreqSlider),
 highCutFreqSliderAttachment(audioProcessor.apvts,"HighCut Freq",highCutFreqSlider),
 lowCutSlopeSliderAttachment(audioProcessor.apvts,"LowCut Slope",lowCutSlopeSlider),
 highCutSlopeSliderAttachment(audioProcessor.apvts,"HighCut Slope",highCutSlopeSlider),
 lowcutBypassButtonAttachment(audioProcessor.apvts, "LowCut Bypassed", lowcutBypassButton),
-highcutBypassButtonAttachment(audioProcessor.apvts, "HighCut Bypassed", highcutBypassButton),
-peakBypassButtonAttachment(audioProcessor.apvts, "Peak Bypassed", peakBypassButton)
+highcutBypassButtonAttachment(audioProcessor.apvts, "HighCut Bypassed", highcutBypassButton)
 
 {
     // Make sure that before the constructor has finished, you've set the
@@ -550,6 +605,28 @@ peakBypassButtonAttachment(audioProcessor.apvts, "Peak Bypassed", peakBypassButt
     
     
     
+    if (auto* oversampling = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.apvts.getParameter("Oversampling")))
+        oversamplingBox.addItemList(oversampling->choices, 1);
+    
+    oversamplingBox.setTooltip("Oversampling");
+    oversamplingAttachment = std::make_unique<APVTS::ComboBoxAttachment>(audioProcessor.apvts, "Oversampling", oversamplingBox);
+    
+    if (auto* phaseMode = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.apvts.getParameter("Phase Mode")))
+        phaseModeBox.addItemList(phaseMode->choices, 1);
+    
+    phaseModeBox.setTooltip("Phase mode, linear adds latency");
+    phaseModeAttachment = std::make_unique<APVTS::ComboBoxAttachment>(audioProcessor.apvts, "Phase Mode", phaseModeBox);
+    
+    if (auto* peakBands = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.apvts.getParameter("Peak Bands")))
+        peakBandsBox.addItemList(peakBands->choices, 1);
+    
+    peakBandsBox.setTooltip("Peak bands in use");
+    peakBandsAttachment = std::make_unique<APVTS::ComboBoxAttachment>(audioProcessor.apvts, "Peak Bands", peakBandsBox);
+    peakBandsBox.onChange = [this] { updatePeakBandBox(); };
+    
+    peakBandBox.setTooltip("Peak band the knobs are editing");
+    peakBandBox.onChange = [this] { selectPeakBand(peakBandBox.getSelectedItemIndex()); };
+    
     for (auto* comp: getComps())
     {
         addAndMakeVisible(comp);
@@ -597,9 +674,56 @@ peakBypassButtonAttachment(audioProcessor.apvts, "Peak Bypassed", peakBypassButt
         }
     };
     
+    // attaches the peak knobs, after the bypass handler exists so it runs for the first band too
+    updatePeakBandBox();
+    
     setSize (600, 480);
 }
 
+void SimpleEQAudioProcessorEditor::updatePeakBandBox()
+{
+    // one entry per band in use
+    auto numBands = juce::jmax(1, peakBandsBox.getSelectedItemIndex() + 1);
+    
+    peakBandBox.clear(juce::dontSendNotification);
+    
+    for(int band = 0; band < numBands; ++band)
+        peakBandBox.addItem("Peak " + juce::String(band + 1), band + 1);
+    
+    auto band = juce::jlimit(0, numBands - 1, selectedPeakBand);
+    peakBandBox.setSelectedItemIndex(band, juce::dontSendNotification);
+    selectPeakBand(band);
+}
+
+void SimpleEQAudioProcessorEditor::selectPeakBand(int band)
+{
+    if(band < 0 || (band == selectedPeakBand && peakFreqSliderAttachment != nullptr))
+        return;
+    
+    selectedPeakBand = band;
+    
+    // the old attachments go first, so the knobs don't write the new band's values into the old band
+    peakFreqSliderAttachment.reset();
+    peakGainSliderAttachment.reset();
+    peakQualitySliderAttachment.reset();
+    peakBypassButtonAttachment.reset();
+    
+    auto& apvts = audioProcessor.apvts;
+    
+    peakFreqSlider.setParameter(*apvts.getParameter(getPeakParameterID(band, "Freq")));
+    peakGainSlider.setParameter(*apvts.getParameter(getPeakParameterID(band, "Gain")));
+    peakQualitySlider.setParameter(*apvts.getParameter(getPeakParameterID(band, "Q")));
+    
+    peakFreqSliderAttachment = std::make_unique<Attachment>(apvts, getPeakParameterID(band, "Freq"), peakFreqSlider);
+    peakGainSliderAttachment = std::make_unique<Attachment>(apvts, getPeakParameterID(band, "Gain"), peakGainSlider);
+    peakQualitySliderAttachment = std::make_unique<Attachment>(apvts, getPeakParameterID(band, "Q"), peakQualitySlider);
+    peakBypassButtonAttachment = std::make_unique<ButtonAttachment>(apvts, getPeakParameterID(band, "Bypassed"), peakBypassButton);
+    
+    // knobs enabled to match the new band's bypass
+    if(peakBypassButton.onClick)
+        peakBypassButton.onClick();
+}
+
 // this is not optional
 SimpleEQAudioProcessorEditor::~SimpleEQAudioProcessorEditor()
 {
@@ -635,6 +759,9 @@ void SimpleEQAudioProcessorEditor::resized()
    auto responseArea = bounds.removeFromTop(bounds.getHeight() * hRatio);
     responseCurveComponent.setBounds(responseArea);
     
+    // load figures sit in the bottom right corner of the response curve
+    loadMeterComponent.setBounds(responseArea.reduced(24, 6).removeFromBottom(14).removeFromRight(230));
+    
     bounds.removeFromTop(5); // make some space between the spectral part and the knobs.
     // Filter controls
     auto lowCutArea = bounds.removeFromLeft(bounds.getWidth()*0.33);
@@ -650,6 +777,16 @@ void SimpleEQAudioProcessorEditor::resized()
     highCutFreqSlider.setBounds(highCutArea.removeFromTop(highCutArea.getHeight()*0.50));
     highCutSlopeSlider.setBounds(highCutArea);
                     
+    // oversampling and phase mode apply to everything, they sit under the peak knobs
+    auto modeArea = bounds.removeFromBottom(24).reduced(4, 2);
+    oversamplingBox.setBounds(modeArea.removeFromLeft(modeArea.getWidth() / 2).withTrimmedRight(2));
+    phaseModeBox.setBounds(modeArea.withTrimmedLeft(2));
+    
+    // band count and the band being edited, above the peak knobs
+    auto bandArea = bounds.removeFromTop(24).reduced(4, 2);
+    peakBandsBox.setBounds(bandArea.removeFromLeft(bandArea.getWidth() / 2).withTrimmedRight(2));
+    peakBandBox.setBounds(bandArea.withTrimmedLeft(2));
+    
     peakBypassButton.setBounds(bounds.removeFromTop(25));
     peakFreqSlider.setBounds(bounds.removeFromTop(bounds.getHeight()*0.33));
     peakGainSlider.setBounds(bounds.removeFromTop(bounds.getHeight()*0.50));
@@ -673,9 +810,14 @@ std::vector<juce::Component*> SimpleEQAudioProcessorEditor::getComps()
         &lowCutSlopeSlider,
         &highCutSlopeSlider,
         &responseCurveComponent,
+        &loadMeterComponent,
         &lowcutBypassButton,
         &peakBypassButton,
-        &highcutBypassButton
+        &highcutBypassButton,
+        &oversamplingBox,
+        &phaseModeBox,
+        &peakBandsBox,
+        &peakBandBox
         
     };
 }
@@ -10,6 +10,8 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "SpectrumAnalyzer.h"
+#include "ResponseCurveWorker.h"
 
 
 // how the fark did he figure out this dark hole
@@ -46,6 +48,12 @@ public:
         setLookAndFeel(nullptr);
     }
     
+    // for the peak knobs, which follow whichever band is selected
+    void setParameter(juce::RangedAudioParameter& rap) {
+        param = &rap;
+        repaint();
+    }
+    
     struct LabelPos {
         float pos;
         juce::String label;
@@ -66,31 +74,77 @@ private:
 };
 
 
-struct ResponseCurveComponent : juce::Component,juce::AudioProcessorParameter::Listener,
+struct ResponseCurveComponent : juce::Component,
 juce::Timer {
     ResponseCurveComponent(SimpleEQAudioProcessor&);
     ~ResponseCurveComponent();
-    void parameterValueChanged (int parameterIndex, float newValue)  override;
-
-   
-    void parameterGestureChanged (int parameterIndex, bool gestureIsStarting) override {};
+    
     void timerCallback() override;
     
     void paint(juce::Graphics& g) override;
     void resized() override;
     
+    // paint time per frame in ms, for keeping an eye on the GUI cost
+    double getAveragePaintMs() const noexcept { return averagePaintMs; }
+    double getWorstPaintMs() const noexcept { return worstPaintMs; }
+    void resetPaintTimes();
+    
+    // off draws everything directly every frame, for comparing paint times
+    void setLayerCacheEnabled(bool shouldBeEnabled);
+    bool isLayerCacheEnabled() const noexcept { return layerCacheEnabled; }
+    
 private:
-    juce::Atomic<bool> parametersChanged {false};
     SimpleEQAudioProcessor&  audioProcessor;
-    MonoChain monoChain;
-    juce::Image background;
     
-    void updateChain();  // helper , called to update monoChain to match parameters
+    // grid / labels, spectrum and curve are each cached in an image at the physical scale
+    // and only redrawn when their own content changes
+    struct Layer {
+        juce::Image image;
+        bool valid {false};
+    };
+    
+    Layer gridLayer, spectrumLayer, curveLayer;
+    float layerScale {1.0f};
+    bool layerCacheEnabled {true};
+    
+    double averagePaintMs {0}, worstPaintMs {0};
+    
+    // the curve is designed and built on the worker thread, paint just strokes the snapshot
+    ResponseCurveWorker curveWorker;
+    ResponseCurveSnapshot::Ptr curve;
+    juce::uint32 curveGeneration {0};
+    
+    // pre / post EQ spectrum, worked out on the analyzer thread, we just stroke the paths
+    SpectrumAnalyzer analyzer;
+    juce::Path preEqSpectrum, postEqSpectrum;
+    juce::uint32 analyzerGeneration {0};
+    
+    void invalidateLayers();
+    void updateLayer(Layer&, bool opaque, const std::function<void(juce::Graphics&)>& draw);
+    
+    void drawGrid(juce::Graphics& g);
+    void drawSpectrum(juce::Graphics& g);
+    void drawCurve(juce::Graphics& g);
     
     juce::Rectangle<int> getRenderArea();
     juce::Rectangle<int> getAnalysisArea();
 };
 
+// small text overlay with the processor's load figures and the curve's paint time,
+// click to reset them
+struct LoadMeterComponent : juce::Component, juce::Timer {
+    LoadMeterComponent(SimpleEQAudioProcessor&, ResponseCurveComponent&);
+    
+    void timerCallback() override;
+    void paint(juce::Graphics& g) override;
+    void mouseDown(const juce::MouseEvent&) override;
+    
+private:
+    SimpleEQAudioProcessor& audioProcessor;
+    ResponseCurveComponent& responseCurve;
+    LoadStatistics statistics;
+};
+
 //==============================================================================
 /**
 */
@@ -122,23 +176,38 @@ private:
     highCutSlopeSlider;
     
     ResponseCurveComponent responseCurveComponent;
+    LoadMeterComponent loadMeterComponent;
     
     
     juce::ToggleButton lowcutBypassButton,highcutBypassButton,peakBypassButton;
+    juce::ComboBox oversamplingBox, phaseModeBox;
+    
+    // how many peak bands are in use, and which one the peak knobs are editing
+    juce::ComboBox peakBandsBox, peakBandBox;
+    int selectedPeakBand {-1};
+    
+    void updatePeakBandBox();
+    void selectPeakBand(int band);
     
     using APVTS = juce::AudioProcessorValueTreeState;
     using Attachment = APVTS::SliderAttachment;
     using ButtonAttachment= APVTS::ButtonAttachment;
     
-    Attachment peakFreqSliderAttachment,
-    peakGainSliderAttachment,
-    peakQualitySliderAttachment,
-    lowCutFreqSliderAttachment,
+    Attachment lowCutFreqSliderAttachment,
     highCutFreqSliderAttachment,
     lowCutSlopeSliderAttachment,
     highCutSlopeSliderAttachment;
     
-    ButtonAttachment lowcutBypassButtonAttachment,highcutBypassButtonAttachment,peakBypassButtonAttachment;
+    ButtonAttachment lowcutBypassButtonAttachment,highcutBypassButtonAttachment;
+    
+    // the peak knobs are re-attached when another band is selected
+    std::unique_ptr<Attachment> peakFreqSliderAttachment, peakGainSliderAttachment, peakQualitySliderAttachment;
+    std::unique_ptr<ButtonAttachment> peakBypassButtonAttachment;
+    
+    // made in the constructor, after the box has its items
+    std::unique_ptr<APVTS::ComboBoxAttachment> oversamplingAttachment;
+    std::unique_ptr<APVTS::ComboBoxAttachment> phaseModeAttachment;
+    std::unique_ptr<APVTS::ComboBoxAttachment> peakBandsAttachment;
     
     std::vector<juce::Component*> getComps();
     
@@ -16,22 +16,32 @@ SimpleEQAudioProcessor::SimpleEQAudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false) // for the dynamic peak
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
                        )
 #endif
 {
+    apvts.addParameterListener("Oversampling", this);
+    apvts.addParameterListener("Phase Mode", this);
 }
 
 SimpleEQAudioProcessor::~SimpleEQAudioProcessor()
 {
+    apvts.removeParameterListener("Oversampling", this);
+    apvts.removeParameterListener("Phase Mode", this);
+    cancelPendingUpdate();
 }
 
 //==============================================================================
 const juce::String SimpleEQAudioProcessor::getName() const
 {
+   #ifdef JucePlugin_Name
     return JucePlugin_Name;
+   #else
+    return "SimpleEQ"; // built into something other than the plugin, e.g. Tools/SimpleEQRender
+   #endif
 }
 
 bool SimpleEQAudioProcessor::acceptsMidi() const
@@ -63,7 +73,13 @@ bool SimpleEQAudioProcessor::isMidiEffect() const
 
 double SimpleEQAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // the cascade's ring out from its pole radii, or the FIR's length
+    auto sampleRate = getSampleRate();
+    
+    if(parameters.isLinearPhase() && sampleRate > 0)
+        return linearPhase.getTailSamples() / sampleRate;
+    
+    return tailLengthSeconds.load();
 }
 
 int SimpleEQAudioProcessor::getNumPrograms()
@@ -96,93 +112,47 @@ void SimpleEQAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlo
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
     juce::dsp::ProcessSpec spec;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = 1;
+    spec.maximumBlockSize = (juce::uint32) (samplesPerBlock * Oversamplers<float>::maxFactor);
+    spec.numChannels = (juce::uint32) getMainBusNumInputChannels(); // not the sidechain
     spec.sampleRate = sampleRate;
     
-    leftChain.prepare(spec);
-    rightChain.prepare(spec);
-    
-    updateFilters(sampleRate);
-    
-     
-
-}
-
-Coefficients makePeakFilter(const ChainSettings& chainSettings, double sampleRate) {
-   return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate,
-                                                        chainSettings.peakFreq, chainSettings.peakQ,
-                                                        juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
-    
-}
-
-
-
-void  SimpleEQAudioProcessor::updatePeakFilter(const ChainSettings& chainSettings,float sampleRate){
-    auto peakCoef = makePeakFilter(chainSettings, sampleRate);
-    
-    leftChain.setBypassed<Peak>(chainSettings.peakBypassed);
-    rightChain.setBypassed<Peak>(chainSettings.peakBypassed);
-    
-    updateCoefficients(leftChain.get<ChainPositions::Peak>().coefficients, peakCoef);
-    updateCoefficients(rightChain.get<ChainPositions::Peak>().coefficients, peakCoef);
-  
-}
-
-void  SimpleEQAudioProcessor::updateHighCutFilters(const ChainSettings& chainSettings,float sampleRate)
-{
-    auto& leftHighCut = leftChain.get<ChainPositions::HighCut>();
-    auto& rightHighCut = rightChain.get<ChainPositions::HighCut>();
- 
-    auto highCutCoeff=
-    makeHighCutFilter(chainSettings, sampleRate);
-    
-    leftChain.setBypassed<HighCut>(chainSettings.highCutBypassed);
-    rightChain.setBypassed<HighCut>(chainSettings.highCutBypassed);
+    // both precisions are prepared, so a host that switches without re-preparing still works
+    floatChain.prepare(spec);
+    doubleChain.prepare(spec);
     
-    updateCutFilter(leftHighCut,  highCutCoeff, chainSettings.highCutSlope, sampleRate);
-    updateCutFilter(rightHighCut, highCutCoeff, chainSettings.highCutSlope, sampleRate);
-     
-}
-
-void  SimpleEQAudioProcessor::updateLowCutFilters(const ChainSettings& chainSettings,float sampleRate)
-{
-    auto& leftLowCut = leftChain.get<ChainPositions::LowCut>();
-    auto& rightLowCut = rightChain.get<ChainPositions::LowCut>();
+    maximumBlockSize = (size_t) samplesPerBlock;
+    floatOversamplers.prepare(spec.numChannels, maximumBlockSize);
+    doubleOversamplers.prepare(spec.numChannels, maximumBlockSize);
     
-   
-    auto lowCutCoeff= makeLowCutFilter(chainSettings, sampleRate);
+    auto coefficients = designer.designNow(sampleRate);
+    setChainCoefficients(*coefficients);
+    setTail(*coefficients);
     
-    leftChain.setBypassed<LowCut>(chainSettings.lowCutBypassed);
-    rightChain.setBypassed<LowCut>(chainSettings.lowCutBypassed);
+    oversamplingFactor = getOversamplingFactor(*coefficients);
     
-    updateCutFilter(leftLowCut,  lowCutCoeff, chainSettings.lowCutSlope, sampleRate);
-    updateCutFilter(rightLowCut, lowCutCoeff, chainSettings.lowCutSlope, sampleRate);
+    auto linearPhaseSpec = spec;
+    linearPhaseSpec.maximumBlockSize = (juce::uint32) samplesPerBlock;
+    linearPhase.prepare(linearPhaseSpec);
+    linearPhaseScratch.setSize((int) spec.numChannels, samplesPerBlock);
+    linearPhaseActive = false; // the first block switches over once the kernel is in
     
-}
-
-void SimpleEQAudioProcessor::updateFilters(float sampleRate)
-{
+    setLatencySamples(getCurrentLatencySamples());
     
+    smoother.prepare(sampleRate, smoothingTimeSeconds, smoothingInterval);
+    smoother.reset(*coefficients);
     
-    auto chainSettings = getChainSettings(apvts);
+    dynamicPeak.prepare(sampleRate, samplesPerBlock);
+    dynamicPeak.setSettings(parameters.getDynamicPeakSettings());
+    dynamicPeak.setCoefficients(*coefficients);
+    dynamicPeak.reset();
+    dynamicActive = false;
     
-    updatePeakFilter(chainSettings, sampleRate);
+    silentSamples = 0;
+    idle = false;
     
-    updateHighCutFilters(chainSettings,sampleRate);
-    updateLowCutFilters(chainSettings,sampleRate);
- 
-     
+    loadMeter.prepare(sampleRate);
 }
 
-void updateCoefficients(Coefficients old,const Coefficients& replacements)
-{
-     *old = *replacements;
- }
-
-
-
-
 void SimpleEQAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
@@ -196,15 +166,13 @@ bool SimpleEQAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout works (mono up to surround / ambisonic beds), the chain is sized
+    // from the channel count in prepareToPlay.
+    if (layouts.getMainOutputChannelSet().isDisabled())
         return false;
 
-    // This checks if the input layout matches the output layout
+    // This checks if the input layout matches the output layout. The sidechain can be
+    // anything, its channels are mixed to mono for the detector.
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
@@ -215,11 +183,116 @@ bool SimpleEQAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
 }
 #endif
 
-void SimpleEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+void SimpleEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    auto start = LoadMeter::now();
+    process(buffer, floatChain, floatOversamplers);
+    loadMeter.addBlock(start, buffer.getNumSamples(), floatChain.getNumSections());
+}
+
+void SimpleEQAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+    auto start = LoadMeter::now();
+    process(buffer, doubleChain, doubleOversamplers);
+    loadMeter.addBlock(start, buffer.getNumSamples(), doubleChain.getNumSections());
+}
+
+void SimpleEQAudioProcessor::setChainCoefficients(const FilterCoefficients& coefficients) noexcept
+{
+    floatChain.setCoefficients(coefficients);
+    doubleChain.setCoefficients(coefficients);
+}
+
+void SimpleEQAudioProcessor::setTail(const FilterCoefficients& coefficients) noexcept
+{
+    tailLengthSeconds = coefficients.tailSeconds;
+    cascadeTailSamples = (juce::int64) std::ceil(coefficients.tailSeconds * getSampleRate());
+}
+
+juce::int64 SimpleEQAudioProcessor::getTailSamples() const noexcept
+{
+    if(linearPhaseActive)
+        return linearPhase.getTailSamples();
+    
+    // the oversampling filters delay (and ring) a little too
+    return cascadeTailSamples + floatOversamplers.getLatencySamples(oversamplingFactor);
+}
+
+template <typename SampleType>
+bool SimpleEQAudioProcessor::isSilent(const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    constexpr auto threshold = (SampleType) 1.0e-7; // -140 dB
+    
+    for(size_t ch = 0; ch < block.getNumChannels(); ++ch)
+    {
+        auto range = juce::FloatVectorOperations::findMinAndMax(block.getChannelPointer(ch), (int) block.getNumSamples());
+        
+        // written so NaN (all compares false) counts as sound, not silence
+        if(! (range.getStart() >= -threshold && range.getEnd() <= threshold))
+            return false;
+    }
+    
+    return true;
+}
+
+void SimpleEQAudioProcessor::resetChains() noexcept
+{
+    floatChain.reset();
+    doubleChain.reset();
+    floatOversamplers.reset();
+    doubleOversamplers.reset();
+}
+
+int SimpleEQAudioProcessor::getOversamplingFactor(const FilterCoefficients& coefficients) const noexcept
+{
+    // sets are designed at host rate x factor, so the factor is just the ratio
+    auto hostRate = getSampleRate();
+    
+    if(hostRate <= 0)
+        return 1;
+    
+    return juce::jlimit(1, Oversamplers<float>::maxFactor, juce::nextPowerOfTwo(juce::roundToInt(coefficients.sampleRate / hostRate)));
+}
+
+void SimpleEQAudioProcessor::parameterChanged(const juce::String&, float)
+{
+    // can be the audio thread during automation
+    triggerAsyncUpdate();
+}
+
+void SimpleEQAudioProcessor::handleAsyncUpdate()
+{
+    // the DSP follows within a block (phase mode) or once the designer has a set at
+    // the new rate (oversampling), a few ms from now
+    setLatencySamples(getCurrentLatencySamples());
+}
+
+bool SimpleEQAudioProcessor::waitForLinearPhaseKernel(int timeoutMs)
+{
+    return ! parameters.isLinearPhase() || linearPhase.waitForKernel(timeoutMs);
+}
+
+int SimpleEQAudioProcessor::getCurrentLatencySamples() noexcept
+{
+    if(parameters.isLinearPhase())
+        return linearPhase.getLatencySamples();
+    
+    return floatOversamplers.getLatencySamples(parameters.getOversamplingFactor());
+}
+
+void SimpleEQAudioProcessor::setLinearPhaseSettings(int kernelLength, int partitionSize)
+{
+    linearPhase.setKernelLength(kernelLength);
+    linearPhase.setPartitionSize(partitionSize);
+}
+
+template <typename SampleType>
+void SimpleEQAudioProcessor::process(juce::AudioBuffer<SampleType>& buffer, MultiChannelChain<SampleType>& chain,
+                                     Oversamplers<SampleType>& oversamplers)
 {
     juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    auto totalNumInputChannels  = getMainBusNumInputChannels();
+    auto totalNumOutputChannels = getMainBusNumOutputChannels();
 
     // In case we have more outputs than inputs, this code clears any output
     // channels that didn't contain input data, (because these aren't
@@ -231,25 +304,261 @@ void SimpleEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
         buffer.clear (i, 0, buffer.getNumSamples());
     
     
-    updateFilters(getSampleRate());
+    // the designer thread does the actual work, we only pick up what it published
+    if(auto* coefficients = designer.getNextCoefficients())
+    {
+        auto factor = getOversamplingFactor(*coefficients);
+        
+        setTail(*coefficients);
+        dynamicPeak.setCoefficients(*coefficients);
+        
+        if(factor != oversamplingFactor)
+        {
+            // oversampling changed: the old state means nothing at the new rate, and there's
+            // nothing sensible to glide between, so start clean
+            oversamplingFactor = factor;
+            resetChains();
+            smoother.reset(*coefficients);
+            setChainCoefficients(*coefficients);
+        }
+        else
+        {
+            smoother.setTarget(*coefficients);
+            
+            // nothing to glide (slope or bypass change), just switch
+            if(! smoother.isSmoothing())
+                setChainCoefficients(*coefficients);
+        }
+    }
+    
+    // switching mode: whatever the other path had in its state is stale by now. Linear only
+    // once the convolution has our kernel, until then the cascade keeps the EQ going.
+    auto linear = parameters.isLinearPhase() && linearPhase.installKernel();
+    
+    if(linear != linearPhaseActive)
+    {
+        linearPhaseActive = linear;
+        
+        if(linear)
+            linearPhase.reset();
+        else
+            resetChains();
+    }
     
+    // dynamic peak: the cascade path only, linear phase keeps the static band
+    dynamicPeak.setSettings(parameters.getDynamicPeakSettings());
+    auto dynamic = dynamicPeak.isActive() && ! linearPhaseActive;
+    
+    if(dynamic != dynamicActive)
+    {
+        dynamicActive = dynamic;
+        
+        if(dynamic)
+            dynamicPeak.reset();
+        else if(smoother.getTarget() != nullptr && ! smoother.isSmoothing())
+            setChainCoefficients(*smoother.getTarget()); // back to the static peak
+    }
     
+    // channels go through the chain in groups, one channel per SIMD lane
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+    auto numChannels = juce::jmin(block.getNumChannels(), (size_t) totalNumInputChannels);
+    auto channels = block.getSubsetChannelBlock(0, numChannels);
+    auto analyze = numAnalyzerUsers.load() > 0;
     
+    if(analyze)
+        preEqFifo.push(channels);
     
+    // idle fast path: once the input has been silent for longer than the tail and nothing
+    // is left ringing, the state is flushed to zero and the blocks are just cleared until
+    // the input comes back
+    auto inputSilent = isSilent(channels);
     
+    if(inputSilent)
+    {
+        silentSamples += (juce::int64) channels.getNumSamples();
+    }
+    else
+    {
+        silentSamples = 0;
+        idle = false;
+    }
     
-    juce::dsp::AudioBlock<float> block(buffer);
-    auto leftBlock = block.getSingleChannelBlock(0);
-    auto rightBlock = block.getSingleChannelBlock(1);
+    if(idle)
+    {
+        channels.clear();
+        numIdleBlocks.store(numIdleBlocks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        
+        if(analyze)
+            postEqFifo.push(channels);
+        
+        return;
+    }
     
-    // this is wierd name , replacing??
-    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
-    leftChain.process(leftContext);
-    rightChain.process(rightContext);
+    if(linearPhaseActive)
+    {
+        processLinearPhase(channels);
+    }
+    else
+    {
+        // the detector listens to the sidechain if it's asked to and the host connected one
+        auto sidechain = getBusCount(true) > 1 ? getBusBuffer(buffer, true, 1) : juce::AudioBuffer<SampleType>();
+        auto detector = dynamicPeak.usesSidechain() && sidechain.getNumChannels() > 0
+                            ? juce::dsp::AudioBlock<SampleType>(sidechain) : channels;
+        auto* stage = oversamplers.get(oversamplingFactor);
+        
+        // the oversamplers and the dynamic steps are only prepared for the promised block size
+        for(size_t start = 0; start < channels.getNumSamples(); start += maximumBlockSize)
+        {
+            auto num = juce::jmin(maximumBlockSize, channels.getNumSamples() - start);
+            auto sub = channels.getSubBlock(start, num);
+            
+            if(dynamicActive)
+                dynamicPeak.detect(detector.getSubBlock(start, num));
+            
+            if(stage != nullptr)
+            {
+                processChain(stage->processSamplesUp(sub), chain);
+                stage->processSamplesDown(sub);
+            }
+            else
+            {
+                processChain(sub, chain);
+            }
+        }
+    }
+    
+    if(inputSilent && silentSamples >= getTailSamples() && ! smoother.isSmoothing() && isSilent(channels))
+    {
+        idle = true;
+        resetChains();
+        linearPhase.reset();
+        dynamicPeak.reset();
+    }
+    
+    if(analyze)
+        postEqFifo.push(channels);
  
 }
 
+void SimpleEQAudioProcessor::processLinearPhase(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    // the convolution is only prepared for the promised block size
+    for(size_t start = 0; start < block.getNumSamples(); start += maximumBlockSize)
+        linearPhase.process(block.getSubBlock(start, juce::jmin(maximumBlockSize, block.getNumSamples() - start)));
+}
+
+void SimpleEQAudioProcessor::processLinearPhase(const juce::dsp::AudioBlock<double>& block) noexcept
+{
+    // the convolution is float only, go through the scratch buffer
+    juce::dsp::AudioBlock<float> scratch (linearPhaseScratch);
+    auto numChannels = juce::jmin(block.getNumChannels(), scratch.getNumChannels());
+    
+    for(size_t start = 0; start < block.getNumSamples(); start += maximumBlockSize)
+    {
+        auto num = juce::jmin(maximumBlockSize, block.getNumSamples() - start);
+        auto sub = scratch.getSubsetChannelBlock(0, numChannels).getSubBlock(0, num);
+        
+        // straight pointer loops, they vectorise. juce 6's AudioBlock::copyFrom only copies
+        // between blocks of the same type.
+        for(size_t ch = 0; ch < numChannels; ++ch)
+        {
+            auto* src = block.getChannelPointer(ch) + start;
+            auto* dst = sub.getChannelPointer(ch);
+            
+            for(size_t i = 0; i < num; ++i)
+                dst[i] = (float) src[i];
+        }
+        
+        linearPhase.process(sub);
+        
+        for(size_t ch = 0; ch < numChannels; ++ch)
+        {
+            auto* src = sub.getChannelPointer(ch);
+            auto* dst = block.getChannelPointer(ch) + start;
+            
+            for(size_t i = 0; i < num; ++i)
+                dst[i] = (double) src[i];
+        }
+    }
+}
+
+template <typename SampleType>
+void SimpleEQAudioProcessor::processChain(const juce::dsp::AudioBlock<SampleType>& block, MultiChannelChain<SampleType>& chain)
+{
+    if(dynamicActive)
+        processDynamic(block, chain);
+    else if(smoother.isSmoothing())
+        processSmoothed(block, chain);
+    else
+        chain.process(block);
+}
+
+template <typename SampleType>
+void SimpleEQAudioProcessor::processDynamic(const juce::dsp::AudioBlock<SampleType>& block, MultiChannelChain<SampleType>& chain)
+{
+    // one stretch per step the detector left for this chunk, with its peak section swapped in.
+    // Steps count host rate samples, the block may be oversampled. Any parameter ramp moves
+    // along at the same steps.
+    auto numSamples = block.getNumSamples();
+    size_t start = 0;
+    
+    for(int k = 0; k < dynamicPeak.getNumSteps() && start < numSamples; ++k)
+    {
+        const auto& step = dynamicPeak.getStep(k);
+        auto num = juce::jmin((size_t) (step.numSamples * oversamplingFactor), numSamples - start);
+        
+        if(smoother.isSmoothing())
+        {
+            const auto& coefficients = smoother.advance(step.numSamples);
+            
+            if(smoother.isSmoothing())
+                chain.setCoefficients(coefficients);
+            else
+                setChainCoefficients(coefficients);
+        }
+        
+        chain.setPeakSection(step.section);
+        chain.process(block.getSubBlock(start, num));
+        start += num;
+    }
+    
+    // the steps always cover the chunk, but just in case
+    if(start < numSamples)
+        chain.process(block.getSubBlock(start, numSamples - start));
+}
+
+template <typename SampleType>
+void SimpleEQAudioProcessor::processSmoothed(const juce::dsp::AudioBlock<SampleType>& block, MultiChannelChain<SampleType>& chain)
+{
+    // new coefficients every control interval, the filter state carries straight on.
+    // The smoother counts host rate samples, the block may be oversampled.
+    auto numSamples = block.getNumSamples();
+    auto hostInterval = smoother.getControlInterval();
+    auto interval = (size_t) (hostInterval * oversamplingFactor);
+    
+    for(size_t start = 0; start < numSamples; start += interval)
+    {
+        const auto& coefficients = smoother.advance(hostInterval);
+        
+        if(! smoother.isSmoothing())
+        {
+            // landed on the target, the rest of the block needs no more updates
+            setChainCoefficients(coefficients);
+            chain.process(block.getSubBlock(start, numSamples - start));
+            return;
+        }
+        
+        chain.setCoefficients(coefficients);
+        chain.process(block.getSubBlock(start, juce::jmin(interval, numSamples - start)));
+    }
+}
+
+void SimpleEQAudioProcessor::setSmoothing(double rampLengthSeconds, int controlInterval)
+{
+    smoothingTimeSeconds = rampLengthSeconds;
+    smoothingInterval = controlInterval;
+}
+
 //==============================================================================
 bool SimpleEQAudioProcessor::hasEditor() const
 {
@@ -268,20 +577,43 @@ void SimpleEQAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
     // You should use this method to store your parameters in the memory block.
     // You could do that either as raw data, or use the XML or ValueTree classes
     // as intermediaries to make it easy to save and load complex data.
+    // just the values, see BinaryState.h. Sessions from before still load through the ValueTree path.
     juce::MemoryOutputStream mos(destData,true);
-    apvts.state.writeToStream(mos);
+    binaryState.write(mos);
 }
 
 void SimpleEQAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
+    if(BinaryState::isBinaryState(data, (size_t) sizeInBytes))
+    {
+        if(binaryState.read(data, (size_t) sizeInBytes))
+            parameters.invalidateAll();
+        
+        return;
+    }
+    
     auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
     if(tree.isValid() )
     {
         apvts.replaceState(tree);
-        updateFilters(getSampleRate());
+        parameters.invalidateAll();
     }
 }
 
+bool SimpleEQAudioProcessor::loadPresetBank(const juce::File& file)
+{
+    return presetBank.open(file);
+}
+
+bool SimpleEQAudioProcessor::applyPreset(int index)
+{
+    if(! presetBank.apply(index, binaryState))
+        return false;
+    
+    parameters.invalidateAll();
+    return true;
+}
+
 juce::AudioProcessorValueTreeState::ParameterLayout
 SimpleEQAudioProcessor::createParameterLayout() {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
@@ -317,33 +649,50 @@ SimpleEQAudioProcessor::createParameterLayout() {
     layout.add(std::make_unique<juce::AudioParameterBool>("Peak Bypassed","Peak Bypassed",false) );
     layout.add(std::make_unique<juce::AudioParameterBool>("HighCut Bypassed","HighCut Bypassed",false) );
     
+    // more peak bands, same ranges as the first. "Peak Bands" is how many of them are in use,
+    // the choice index is the number of extra bands.
+    juce::StringArray bandCounts;
+    
+    for(int n = 1; n <= MaxPeakBands; ++n)
+        bandCounts.add(juce::String(n));
+    
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Peak Bands", "Peak Bands", bandCounts, 0));
+    
+    for(int band = 1; band < MaxPeakBands; ++band) {
+        // spread out over the spectrum, so adding a band doesn't stack it on the others
+        auto defaultFreq = std::round(juce::mapToLog10((float) band / (float) MaxPeakBands, 20.0f, 20000.0f));
+        
+        layout.add(std::make_unique<juce::AudioParameterFloat>(getPeakParameterID(band, "Freq"), getPeakParameterID(band, "Freq"),
+                                                               juce::NormalisableRange<float>(20.0f, 20000.0f,1.0f,0.25f), defaultFreq));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(getPeakParameterID(band, "Gain"), getPeakParameterID(band, "Gain"),
+                                                               juce::NormalisableRange<float>(-24.f, 24.f,0.5f,1.0f), 0.0f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(getPeakParameterID(band, "Q"), getPeakParameterID(band, "Q"),
+                                                               juce::NormalisableRange<float>(0.1f,10.f,0.05f,1.0f), 1.0f));
+        layout.add(std::make_unique<juce::AudioParameterBool>(getPeakParameterID(band, "Bypassed"), getPeakParameterID(band, "Bypassed"), false));
+    }
+    
+    // dynamic mode for the first peak band, see DynamicPeak.h. Gain is pulled down by
+    // (level - threshold) * (1 - 1 / ratio) dB when its band of the input (or sidechain) is over the threshold.
+    layout.add(std::make_unique<juce::AudioParameterBool>("Peak Dynamic","Peak Dynamic",false) );
+    layout.add(std::make_unique<juce::AudioParameterBool>("Peak Sidechain","Peak Sidechain",false) );
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Threshold", "Peak Threshold", juce::NormalisableRange<float>(-60.f, 0.f,0.5f,1.0f), -24.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Ratio", "Peak Ratio", juce::NormalisableRange<float>(1.f, 20.f,0.1f,0.4f), 2.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Attack", "Peak Attack", juce::NormalisableRange<float>(0.1f, 200.f,0.1f,0.3f), 10.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Release", "Peak Release", juce::NormalisableRange<float>(5.f, 2000.f,1.0f,0.3f), 100.0f));
+    
+    // filters are designed at host rate x this, see Oversamplers.h
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Oversampling", "Oversampling",
+                                                            juce::StringArray {"Off", "2x", "4x", "8x"}, 0));
+    
+    // linear phase runs the whole EQ as one FIR, see LinearPhaseEQ.h
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Phase Mode", "Phase Mode",
+                                                            juce::StringArray {"Minimum", "Linear"}, 0));
+    
     return layout;
     
 }
 
 
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState&  apvts) {
-    ChainSettings chain;
-   
-    chain.lowCutFreq  = apvts.getRawParameterValue("LowCut Freq")->load();
-    chain.highCutFreq = apvts.getRawParameterValue("HighCut Freq")->load();
-    chain.lowCutSlope = static_cast<Slope> (apvts.getRawParameterValue("LowCut Slope")->load());
-    chain.highCutSlope = static_cast<Slope> (apvts.getRawParameterValue("HighCut Slope")->load());
-    chain.peakFreq = apvts.getRawParameterValue("Peak Freq")->load();
-    chain.peakQ = apvts.getRawParameterValue("Peak Q")->load();
-    chain.peakGainInDecibels = apvts.getRawParameterValue("Peak Gain")->load();
- 
-    chain.lowCutBypassed = apvts.getRawParameterValue("LowCut Bypassed")->load() > 0.5f;
-    chain.peakBypassed = apvts.getRawParameterValue("Peak Bypassed")->load() > 0.5f;
-    chain.highCutBypassed = apvts.getRawParameterValue("HighCut Bypassed")->load() > 0.5f;
-    return chain;
-}
-
-
-
-
-
-
 //==============================================================================
 // This creates new instances of the plugin..
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -9,107 +9,24 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "FilterChain.h"
+#include "CoefficientDesigner.h"
+#include "SIMDChain.h"
+#include "CoefficientSmoother.h"
+#include "LoadMeter.h"
+#include "AnalyzerFifo.h"
+#include "Oversamplers.h"
+#include "LinearPhaseEQ.h"
+#include "DynamicPeak.h"
+#include "BinaryState.h"
+#include "PresetBank.h"
 
 //==============================================================================
 /**
 */
-enum Slope
-{
-    Slope_12,
-    Slope_24,
-    Slope_36,
-    Slope_48
-};
-
-struct ChainSettings
-{
-    float peakFreq {0},peakGainInDecibels{0}, peakQ {1.0f};
-    float lowCutFreq {0},highCutFreq{0};
-    Slope lowCutSlope {Slope::Slope_12},highCutSlope{Slope::Slope_12};
-    
-    bool lowCutBypassed {false},highCutBypassed {false}, peakBypassed {false};
-};
-
-using Filter = juce::dsp::IIR::Filter<float>;
-using CutFilter = juce::dsp::ProcessorChain<Filter,Filter,Filter,Filter>;
-using MonoChain = juce::dsp::ProcessorChain<CutFilter,Filter,CutFilter>;
-
-enum ChainPositions
-{
-    LowCut,
-    Peak,
-    HighCut
-};
-
-
-using Coefficients = Filter::CoefficientsPtr;
-
-void updateCoefficients(Coefficients old, const Coefficients& replacements);
-
-Coefficients makePeakFilter(const ChainSettings& chainSettings, const double samplerate);
-
-//note that these are defined here because they need to be defined before use with auto type.
-// they are inline otherwise it will be duplicat symbols.
-
-inline auto makeHighCutFilter(const ChainSettings& chainSettings, double sampleRate) {
-    return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(
-                   chainSettings.highCutFreq, sampleRate, (chainSettings.highCutSlope+1)*2);
-}
-
-inline auto makeLowCutFilter(const ChainSettings& chainSettings, double sampleRate) {
-    return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(
-                   chainSettings.lowCutFreq, sampleRate,(chainSettings.lowCutSlope+1)*2);
-}
-
-
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState&  );
-
-// helper
-
-template  <int Index, typename ChainType,typename CoefficientType>
-void update(ChainType& chain,const CoefficientType& cutCoeffs){
-    
-    updateCoefficients(chain.template get<Index>().coefficients, cutCoeffs[Index]);
-    chain.template setBypassed<Index>(false);
-}
-
-// setup cut filteres
-
-template<typename ChainType,typename CoefficientType>
-void updateCutFilter(ChainType& cutFilter, const CoefficientType& cutCoeffs,
-                     const Slope& cutSlope, const float sampleRate) {
-
-    
- 
-    cutFilter.template setBypassed<0>(true);
-    cutFilter.template setBypassed<1>(true);
-    cutFilter.template setBypassed<2>(true);
-    cutFilter.template setBypassed<3>(true);
-    
-    switch(cutSlope)
-    {
-         
-            
-        case Slope_48:
-            update<3>(cutFilter,cutCoeffs);
-        
-            
-        case Slope_36:
-            update<2>(cutFilter,cutCoeffs);
-            
-        case Slope_24:
-            update<1>(cutFilter,cutCoeffs);
-   
-        case Slope_12:
-            update<0>(cutFilter,cutCoeffs);
-
-
-       }
-    
-    
-}
-
-class SimpleEQAudioProcessor  : public juce::AudioProcessor
+class SimpleEQAudioProcessor  : public juce::AudioProcessor,
+                                private juce::AudioProcessorValueTreeState::Listener,
+                                private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -125,6 +42,10 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    
+    // 64 bit hosts get a double chain, no conversion on every insert
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -152,6 +73,52 @@ public:
     static juce::AudioProcessorValueTreeState::ParameterLayout  createParameterLayout() ;
     juce::AudioProcessorValueTreeState apvts {*this, nullptr,"Parameters", createParameterLayout()};
     
+    // presets come from a memory mapped bank file, see PresetBank.h. Message thread.
+    bool loadPresetBank(const juce::File& file);
+    const PresetBank& getPresetBank() const noexcept { return presetBank; }
+    bool applyPreset(int index);
+    
+    // FIR length and convolution partition size for the linear phase mode, latency is
+    // kernelLength / 2 + partitionSize. Takes effect on the next prepareToPlay.
+    void setLinearPhaseSettings(int kernelLength, int partitionSize);
+    
+    // for offline renders, after prepareToPlay: waits until linear phase mode has its kernel
+    // in the convolution, so the first block doesn't depend on thread timing. A host never
+    // needs this, the cascade runs until then. False if it took longer than timeoutMs.
+    bool waitForLinearPhaseKernel(int timeoutMs = 5000);
+    
+    // how long parameter changes glide for, and how many samples between coefficient
+    // updates while they do. Takes effect on the next prepareToPlay.
+    void setSmoothing(double rampLengthSeconds, int controlInterval);
+    
+    // control rate cost so far: number of updates and of biquad sections designed for them
+    juce::uint64 getNumSmoothingUpdates() const noexcept { return smoother.getNumUpdates(); }
+    juce::uint64 getNumSmoothingSectionsDesigned() const noexcept { return smoother.getNumSectionsDesigned(); }
+    
+    // processBlock time as a fraction of the block's duration, see LoadMeter.h. Any thread.
+    LoadStatistics getLoadStatistics() const noexcept { return loadMeter.getStatistics(); }
+    void resetLoadStatistics() noexcept { loadMeter.reset(); }
+    
+    // blocks skipped because the input was silent and the filters had rung out. Any thread.
+    juce::uint64 getNumIdleBlocks() const noexcept { return numIdleBlocks.load(std::memory_order_relaxed); }
+    
+    // where the dynamic peak has pulled the Peak band's gain to, in dB. Any thread.
+    float getDynamicPeakGain() const noexcept { return dynamicPeak.getCurrentGainInDecibels(); }
+    
+    // the coefficient sets the audio thread runs, published for the editors with a generation
+    // counter to poll, so a parameter change is designed once however many editors are open
+    const CoefficientDesigner& getCoefficientDesigner() const noexcept { return designer; }
+    
+    // hits and misses of the butterworth cache every instance in the process shares
+    CoefficientCache::Statistics getCoefficientCacheStatistics() const noexcept { return designer.getCache().getStatistics(); }
+    
+    // mono mixes of the input and output for the spectrum analyzer. Only filled while at
+    // least one analyzer uses them, otherwise the audio thread skips them entirely.
+    // Every analyzer adds itself once and removes itself once, message thread.
+    AnalyzerFifo& getAnalyzerFifo(bool postEq) noexcept { return postEq ? postEqFifo : preEqFifo; }
+    void addAnalyzerUser() noexcept { ++numAnalyzerUsers; }
+    void removeAnalyzerUser() noexcept { jassert(numAnalyzerUsers > 0); --numAnalyzerUsers; }
+    
     
     
     
@@ -159,14 +126,74 @@ public:
     
 private:
     
-    void  updateFilters(float sampleRate);
-    void  updatePeakFilter(const ChainSettings& cs,float sampleRate);
-    void  updateHighCutFilters(const ChainSettings& cs,float sampleRate);
-    void  updateLowCutFilters(const ChainSettings& cs,float sampleRate);
+    ParameterSnapshot parameters {apvts};
+    BinaryState binaryState {apvts};
+    PresetBank presetBank;
+    CoefficientDesigner designer {parameters};
     
-
+    MultiChannelChain<float> floatChain;
+    MultiChannelChain<double> doubleChain;
+    CoefficientSmoother smoother;
+    LoadMeter loadMeter;
+    
+    AnalyzerFifo preEqFifo, postEqFifo;
+    std::atomic<int> numAnalyzerUsers {0};    // open editors, so closing one doesn't stop the others
+    
+    double smoothingTimeSeconds {0.05};
+    int smoothingInterval {32};
+    
+    // oversampling: every factor prepared for both precisions, the one in use follows the
+    // rate of the coefficient set the audio thread is running
+    Oversamplers<float> floatOversamplers;
+    Oversamplers<double> doubleOversamplers;
+    int oversamplingFactor {1};
+    size_t maximumBlockSize {0};
+    
+    int getOversamplingFactor(const FilterCoefficients&) const noexcept;
+    int getCurrentLatencySamples() noexcept;
+    
+    // tail and idle detection. tailLengthSeconds is the cascade's, read by the host from any thread.
+    std::atomic<double> tailLengthSeconds {0};
+    juce::int64 cascadeTailSamples {0}, silentSamples {0};
+    bool idle {false};
+    std::atomic<juce::uint64> numIdleBlocks {0};
+    
+    void setTail(const FilterCoefficients&) noexcept;
+    juce::int64 getTailSamples() const noexcept;
+    
+    template <typename SampleType>
+    static bool isSilent(const juce::dsp::AudioBlock<SampleType>& block) noexcept;
+    
+    // linear phase mode replaces the whole cascade (and the oversampling) with one FIR
+    LinearPhaseEQ linearPhase {parameters};
+    juce::AudioBuffer<float> linearPhaseScratch;    // the double path goes through this
+    bool linearPhaseActive {false};
+    
+    // dynamic gain for the Peak band, detected per chunk before the chain runs over it
+    DynamicPeak dynamicPeak;
+    bool dynamicActive {false};
+    
+    // latency has to be reported from the message thread when oversampling or phase mode change
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+    
+    void setChainCoefficients(const FilterCoefficients&) noexcept;
+    void resetChains() noexcept;
+    
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>&, MultiChannelChain<SampleType>&, Oversamplers<SampleType>&);
+    
+    void processLinearPhase(const juce::dsp::AudioBlock<float>& block) noexcept;
+    void processLinearPhase(const juce::dsp::AudioBlock<double>& block) noexcept;
+    
+    template <typename SampleType>
+    void processChain(const juce::dsp::AudioBlock<SampleType>& block, MultiChannelChain<SampleType>& chain);
+    
+    template <typename SampleType>
+    void processSmoothed(const juce::dsp::AudioBlock<SampleType>& block, MultiChannelChain<SampleType>& chain);
     
-    MonoChain leftChain,rightChain;
+    template <typename SampleType>
+    void processDynamic(const juce::dsp::AudioBlock<SampleType>& block, MultiChannelChain<SampleType>& chain);
     
    
     
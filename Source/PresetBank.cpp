@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    A file of presets that is memory mapped and indexed, so listing and
+    applying one doesn't parse the others.
+
+  ==============================================================================
+*/
+
+#include "PresetBank.h"
+
+bool PresetBank::open(const juce::File& newFile)
+{
+    close();
+
+    auto map = std::make_unique<juce::MemoryMappedFile>(newFile, juce::MemoryMappedFile::readOnly);
+    auto* data = static_cast<const char*>(map->getData());
+    auto size = map->getSize();
+
+    if (data == nullptr || size < headerSize || juce::ByteOrder::littleEndianInt(data) != magic)
+        return false;
+
+    auto version = (int) juce::ByteOrder::littleEndianShort(data + 4);
+    auto count = (size_t) juce::ByteOrder::littleEndianInt(data + 8);
+
+    if (version > currentVersion || count > (size - headerSize) / indexEntrySize)
+        return false;
+
+    // every entry has to point inside the file, then nothing later needs checking
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto* e = data + headerSize + i * indexEntrySize;
+        auto nameOffset = (juce::uint64) juce::ByteOrder::littleEndianInt(e);
+        auto nameSize = (juce::uint64) juce::ByteOrder::littleEndianInt(e + 4);
+        auto stateOffset = (juce::uint64) juce::ByteOrder::littleEndianInt(e + 8);
+        auto stateSize = (juce::uint64) juce::ByteOrder::littleEndianInt(e + 12);
+
+        if (nameOffset + nameSize > size || stateOffset + stateSize > size)
+            return false;
+    }
+
+    file = newFile;
+    mapped = std::move(map);
+    numPresets = (int) count;
+    return true;
+}
+
+void PresetBank::close()
+{
+    mapped.reset();
+    file = juce::File();
+    numPresets = 0;
+}
+
+PresetBank::IndexEntry PresetBank::getEntry(int index) const noexcept
+{
+    jassert(juce::isPositiveAndBelow(index, numPresets));
+
+    auto* e = getData() + headerSize + (size_t) index * indexEntrySize;
+
+    return { juce::ByteOrder::littleEndianInt(e), juce::ByteOrder::littleEndianInt(e + 4),
+             juce::ByteOrder::littleEndianInt(e + 8), juce::ByteOrder::littleEndianInt(e + 12) };
+}
+
+juce::String PresetBank::getName(int index) const
+{
+    if (! juce::isPositiveAndBelow(index, numPresets))
+        return {};
+
+    auto entry = getEntry(index);
+    return juce::String::fromUTF8(getData() + entry.nameOffset, (int) entry.nameSize);
+}
+
+int PresetBank::indexOf(const juce::String& name) const
+{
+    // compares the raw bytes, no String per preset
+    auto* utf8 = name.toRawUTF8();
+    auto size = name.getNumBytesAsUTF8();
+
+    for (int i = 0; i < numPresets; ++i)
+    {
+        auto entry = getEntry(i);
+
+        if (entry.nameSize == size && std::memcmp(getData() + entry.nameOffset, utf8, size) == 0)
+            return i;
+    }
+
+    return -1;
+}
+
+bool PresetBank::apply(int index, BinaryState& state) const
+{
+    if (! juce::isPositiveAndBelow(index, numPresets))
+        return false;
+
+    auto entry = getEntry(index);
+    return state.read(getData() + entry.stateOffset, entry.stateSize);
+}
+
+bool PresetBank::write(const juce::File& file, const juce::Array<Preset>& presets)
+{
+    juce::MemoryOutputStream out;
+
+    out.writeInt((int) magic);
+    out.writeShort((short) currentVersion);
+    out.writeShort(0);
+    out.writeInt(presets.size());
+
+    // names and states go after the index, in the same order
+    auto offset = headerSize + (size_t) presets.size() * indexEntrySize;
+
+    for (const auto& preset : presets)
+    {
+        auto nameSize = preset.name.getNumBytesAsUTF8();
+
+        out.writeInt((int) offset);
+        out.writeInt((int) nameSize);
+        out.writeInt((int) (offset + nameSize));
+        out.writeInt((int) preset.state.getSize());
+
+        offset += nameSize + preset.state.getSize();
+    }
+
+    for (const auto& preset : presets)
+    {
+        out.write(preset.name.toRawUTF8(), preset.name.getNumBytesAsUTF8());
+        out.write(preset.state.getData(), preset.state.getSize());
+    }
+
+    // whole file at once, so an open bank never sees it half written
+    return file.replaceWithData(out.getData(), out.getDataSize());
+}
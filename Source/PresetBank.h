@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    A file of presets that is memory mapped and indexed, so listing and
+    applying one doesn't parse the others.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BinaryState.h"
+
+// Layout, little endian, offsets from the start of the file:
+//
+//   uint32  magic ('SEQK')
+//   uint16  version
+//   uint16  reserved, 0
+//   uint32  number of presets
+//   then per preset: uint32 name offset, uint32 name size, uint32 state offset, uint32 state size
+//   then the names (UTF-8, no terminator) and the states (BinaryState data)
+//
+// open() maps the file and checks the index once, after that a name is a pointer and a length
+// and applying a preset reads its values straight out of the mapping. Nothing else is read,
+// so a bank of thousands opens as fast as a bank of ten.
+class PresetBank
+{
+public:
+    struct Preset
+    {
+        juce::String name;
+        juce::MemoryBlock state;    // from BinaryState::write
+    };
+
+    static constexpr juce::uint32 magic = 0x4b514553;   // "SEQK"
+    static constexpr int currentVersion = 1;
+
+    // false if the file can't be mapped or isn't a valid bank. Message thread.
+    bool open(const juce::File& file);
+    void close();
+
+    bool isOpen() const noexcept { return mapped != nullptr; }
+    const juce::File& getFile() const noexcept { return file; }
+
+    int getNumPresets() const noexcept { return numPresets; }
+    juce::String getName(int index) const;
+
+    // -1 if there isn't one
+    int indexOf(const juce::String& name) const;
+
+    bool apply(int index, BinaryState& state) const;
+
+    static bool write(const juce::File& file, const juce::Array<Preset>& presets);
+
+    static constexpr size_t headerSize = 12, indexEntrySize = 16;
+
+private:
+    struct IndexEntry
+    {
+        juce::uint32 nameOffset, nameSize, stateOffset, stateSize;
+    };
+
+    IndexEntry getEntry(int index) const noexcept;
+    const char* getData() const noexcept { return static_cast<const char*>(mapped->getData()); }
+
+    juce::File file;
+    std::unique_ptr<juce::MemoryMappedFile> mapped;
+    int numPresets {0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PresetBank)
+};
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    Per band magnitude response, cached per pixel of the response curve.
+
+  ==============================================================================
+*/
+
+#include "ResponseCurveCache.h"
+
+void ResponseCurveCache::prepare(int newWidth, double newSampleRate)
+{
+    newWidth = juce::jmax(0, newWidth);
+
+    if(newWidth == width && newSampleRate == sampleRate)
+        return;
+
+    width = newWidth;
+    sampleRate = newSampleRate;
+
+    // padded up to whole registers, the spare lanes are never read back
+    auto numGroups = (width + lanes - 1) / lanes;
+    phi.assign(numGroups, SIMDType::expand(0.0));
+
+    for (int i = 0; i < width; ++i)
+    {
+        // same mapping as the response curve and the analyzer
+        auto freq = juce::mapToLog10((double) i / (double) width, minFrequency, maxFrequency);
+        auto s = std::sin(juce::MathConstants<double>::pi * freq / sampleRate);
+        phi[(size_t) i / lanes].set((size_t) i % lanes, s * s);
+    }
+
+    for (auto& band : bands)
+    {
+        band.numSections = -1;
+        band.decibels.assign((size_t) width, 0.0f);
+    }
+
+    total.assign((size_t) width, 0.0f);
+}
+
+void ResponseCurveCache::update(const FilterCoefficients& c)
+{
+    const auto& cs = c.settings;
+
+    auto changed = updateBand(bands[LowCut], c.lowCut.data(), cs.lowCutSlope + 1, cs.lowCutBypassed);
+    changed = updateBand(bands[Peak], &c.peak, 1, cs.peakBypassed) || changed;
+    changed = updateBand(bands[HighCut], c.highCut.data(), cs.highCutSlope + 1, cs.highCutBypassed) || changed;
+
+    // bands beyond the count are treated as bypassed
+    for (size_t i = 0; i < (size_t) MaxExtraPeakBands; ++i)
+    {
+        auto inUse = (int) i < cs.extraPeaks.numBands;
+        changed = updateBand(bands[3 + i], &c.extraPeaks[i], 1, ! inUse || cs.extraPeaks.bypassed[i]) || changed;
+    }
+
+    if(! changed)
+        return;
+
+    std::fill(total.begin(), total.end(), 0.0f);
+
+    for (const auto& band : bands)
+        if(! band.bypassed)
+            juce::FloatVectorOperations::add(total.data(), band.decibels.data(), width);
+}
+
+bool ResponseCurveCache::updateBand(Band& band, const SectionCoefficients* sections, int numSections, bool bypassed)
+{
+    auto bypassChanged = band.bypassed != bypassed;
+    band.bypassed = bypassed;
+
+    // a bypassed band keeps its old curve, it just isn't summed
+    if(bypassed)
+        return bypassChanged;
+
+    if(band.numSections == numSections && std::equal(sections, sections + numSections, band.sections.begin()))
+        return bypassChanged;
+
+    band.numSections = numSections;
+    std::copy(sections, sections + numSections, band.sections.begin());
+
+    evaluate(band);
+    return true;
+}
+
+void ResponseCurveCache::evaluate(Band& band)
+{
+    ++numBandEvaluations;
+
+    // the phi polynomials for numerator and denominator of each section
+    struct Polynomial { SIMDType k0, k1, k2; };
+    std::array<Polynomial, 4> numerators, denominators;
+
+    auto makePolynomial = [](double c0, double c1, double c2)
+    {
+        return Polynomial { SIMDType::expand((c0 + c1 + c2) * (c0 + c1 + c2)),
+                            SIMDType::expand(-4.0 * (c0 * c1 + 4.0 * c0 * c2 + c1 * c2)),
+                            SIMDType::expand(16.0 * c0 * c2) };
+    };
+
+    for (size_t k = 0; k < (size_t) band.numSections; ++k)
+    {
+        const auto& s = band.sections[k];
+        numerators[k] = makePolynomial(s[0], s[1], s[2]);
+        denominators[k] = makePolynomial(1.0, s[3], s[4]);
+    }
+
+    alignas(SIMDType) double num[lanes], den[lanes];
+
+    for (size_t g = 0; g < phi.size(); ++g)
+    {
+        auto p = phi[g];
+        auto n = SIMDType::expand(1.0);
+        auto d = SIMDType::expand(1.0);
+
+        for (size_t k = 0; k < (size_t) band.numSections; ++k)
+        {
+            n = n * (numerators[k].k0 + p * (numerators[k].k1 + p * numerators[k].k2));
+            d = d * (denominators[k].k0 + p * (denominators[k].k1 + p * denominators[k].k2));
+        }
+
+        n.copyToRawArray(num);
+        d.copyToRawArray(den);
+
+        // no SIMD log, the ratio and dB per lane are cheap enough
+        for (size_t l = 0; l < lanes; ++l)
+        {
+            auto i = g * lanes + l;
+
+            if(i < (size_t) width)
+                band.decibels[i] = (float) (10.0 * std::log10(juce::jmax(num[l] / den[l], 1.0e-10)));
+        }
+    }
+}
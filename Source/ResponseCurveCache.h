@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    Per band magnitude response, cached per pixel of the response curve.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CoefficientDesigner.h"
+
+// Holds the response of each band (LowCut, Peak, HighCut, then the extra peaks) in dB at every pixel of the
+// analysis area, for a given width and sample rate. The per pixel frequencies are worked
+// out once in prepare(), and update() only re-evaluates the bands whose sections actually
+// changed, so dragging one knob costs one band, not every biquad at every pixel.
+//
+// The evaluation runs on SIMDRegister<double>, a few pixels per register. Instead of the
+// complex exponentials it uses phi = sin^2(w/2) per pixel, which gives the same
+// |H(e^jw)|^2 without the cancellation the exponential form has near DC:
+//
+//   |b0 + b1 z^-1 + b2 z^-2|^2 = (b0 + b1 + b2)^2 - 4 (b0 b1 + 4 b0 b2 + b1 b2) phi + 16 b0 b2 phi^2
+class ResponseCurveCache
+{
+public:
+    static constexpr double minFrequency = 20.0, maxFrequency = 20000.0;
+
+    // cheap if nothing changed, otherwise everything is re-evaluated on the next update
+    void prepare(int width, double sampleRate);
+
+    // re-evaluates only the bands that differ from last time
+    void update(const FilterCoefficients& coefficients);
+
+    // total response in dB per pixel, the sum of the active bands
+    const std::vector<float>& getDecibels() const noexcept { return total; }
+
+    int getWidth() const noexcept { return width; }
+
+    // how many band evaluations have been done, for keeping an eye on it
+    juce::uint64 getNumBandEvaluations() const noexcept { return numBandEvaluations; }
+
+private:
+    using SIMDType = juce::dsp::SIMDRegister<double>;
+    static constexpr size_t lanes = SIMDType::SIMDNumElements;
+
+    struct Band
+    {
+        std::array<SectionCoefficients, 4> sections {};
+        int numSections {-1};           // -1: never evaluated
+        bool bypassed {false};
+        std::vector<float> decibels;
+    };
+
+    bool updateBand(Band&, const SectionCoefficients* sections, int numSections, bool bypassed);
+    void evaluate(Band&);
+
+    int width {0};
+    double sampleRate {0};
+
+    std::vector<SIMDType> phi;          // sin^2(w/2) per pixel, lanes pixels per register
+    std::array<Band, 3 + MaxExtraPeakBands> bands;  // ChainPositions, then the extra peaks
+    std::vector<float> total;
+
+    juce::uint64 numBandEvaluations {0};
+};
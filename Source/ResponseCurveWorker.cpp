@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+    Builds the response curve off the message thread.
+
+  ==============================================================================
+*/
+
+#include "ResponseCurveWorker.h"
+
+ResponseCurveWorker::ResponseCurveWorker(const CoefficientDesigner& d) : designer(d)
+{
+    thread->addTimeSliceClient(this);
+}
+
+ResponseCurveWorker::~ResponseCurveWorker()
+{
+    // waits for a running slice to finish
+    thread->removeTimeSliceClient(this);
+}
+
+void ResponseCurveWorker::setArea(juce::Rectangle<int> newArea)
+{
+    const juce::ScopedLock sl(lock);
+    area = newArea;
+}
+
+ResponseCurveSnapshot::Ptr ResponseCurveWorker::getSnapshot() const
+{
+    const juce::ScopedLock sl(lock);
+    return snapshot;
+}
+
+int ResponseCurveWorker::useTimeSlice()
+{
+    // well inside a 60 Hz frame, and nothing but a few compares while idle
+    constexpr int pollIntervalMs = 10;
+
+    juce::Rectangle<int> currentArea;
+
+    {
+        const juce::ScopedLock sl(lock);
+        currentArea = area;
+    }
+
+    // one atomic load while nothing changes
+    auto designerGeneration = designer.getPublishedGeneration();
+
+    if(designerGeneration == builtGeneration && currentArea == builtArea)
+        return pollIntervalMs;
+
+    if(currentArea.isEmpty())
+        return pollIntervalMs;
+
+    if(designerGeneration != builtGeneration)
+    {
+        // the set the audio thread is getting, so the curve is what we hear
+        builtCoefficients = designer.getPublished();
+        builtGeneration = designerGeneration;
+    }
+
+    if(builtCoefficients == nullptr)
+        return pollIntervalMs;
+
+    auto newSnapshot = new ResponseCurveSnapshot();
+    ResponseCurveSnapshot::Ptr ptr (newSnapshot);
+
+    newSnapshot->coefficients = builtCoefficients;
+    newSnapshot->area = currentArea;
+
+    cache.prepare(currentArea.getWidth(), builtCoefficients->sampleRate);
+    cache.update(*builtCoefficients);
+    newSnapshot->path = makePath(currentArea);
+
+    builtArea = currentArea;
+
+    {
+        const juce::ScopedLock sl(lock);
+        snapshot = ptr;
+    }
+
+    ++generation;
+    return pollIntervalMs;
+}
+
+juce::Path ResponseCurveWorker::makePath(juce::Rectangle<int> pathArea) const
+{
+    const auto& mags = cache.getDecibels();
+    juce::Path responseCurve;
+
+    if(mags.empty())
+        return responseCurve;
+
+    const double outputMin = pathArea.getBottom();
+    const double outputMax = pathArea.getY();
+
+    auto map = [outputMin,outputMax](double input){
+        return (float) juce::jmap(input, minDecibels, maxDecibels, outputMin, outputMax);
+    };
+
+    responseCurve.preallocateSpace((int) mags.size() * 3);
+    responseCurve.startNewSubPath((float) pathArea.getX(), map(mags.front()));
+
+    for(size_t i=1;i< mags.size();++i) {
+        responseCurve.lineTo((float) pathArea.getX() + (float) i, map(mags[i]));
+    }
+
+    return responseCurve;
+}
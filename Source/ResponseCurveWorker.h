@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    Builds the response curve off the message thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ResponseCurveCache.h"
+#include "CoefficientDesigner.h"
+
+// A finished curve, ready to stroke. Never changed after it's published.
+struct ResponseCurveSnapshot : juce::ReferenceCountedObject
+{
+    using Ptr = juce::ReferenceCountedObjectPtr<ResponseCurveSnapshot>;
+
+    juce::Path path;
+    juce::Rectangle<int> area;
+    FilterCoefficients::Ptr coefficients;
+};
+
+// Evaluates the per band cache and builds the Path on a thread shared by every open editor.
+// The coefficients aren't designed here: it takes the set the CoefficientDesigner published
+// for the audio thread (at the same rate, oversampling included), polling its generation,
+// so no parameter listeners are needed. The message thread only swaps in the latest
+// snapshot and strokes it.
+class ResponseCurveWorker : private juce::TimeSliceClient
+{
+public:
+    static constexpr double minDecibels = -24.0, maxDecibels = 24.0;
+
+    explicit ResponseCurveWorker(const CoefficientDesigner& designer);
+    ~ResponseCurveWorker() override;
+
+    // message thread: the analysis area, in the component's coordinates
+    void setArea(juce::Rectangle<int> area);
+
+    // bumped each time a new snapshot is published
+    juce::uint32 getGeneration() const noexcept { return generation.load(); }
+
+    ResponseCurveSnapshot::Ptr getSnapshot() const;
+
+private:
+    int useTimeSlice() override;
+
+    juce::Path makePath(juce::Rectangle<int> area) const;
+
+    struct CurveThread : juce::TimeSliceThread
+    {
+        CurveThread() : juce::TimeSliceThread("SimpleEQ curves") { startThread(); }
+        ~CurveThread() override { stopThread(1000); }
+    };
+
+    const CoefficientDesigner& designer;
+
+    std::atomic<juce::uint32> generation {0};
+
+    // worker thread only
+    ResponseCurveCache cache;
+    juce::Rectangle<int> builtArea;
+    juce::uint32 builtGeneration {0};
+    FilterCoefficients::Ptr builtCoefficients;
+
+    juce::CriticalSection lock;                         // area and snapshot, worker vs message thread
+    juce::Rectangle<int> area;
+    ResponseCurveSnapshot::Ptr snapshot;
+
+    juce::SharedResourcePointer<CurveThread> thread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResponseCurveWorker)
+};
@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    Runs the filter chain once for several channels, one channel per SIMD lane.
+
+  ==============================================================================
+*/
+
+#include "SIMDChain.h"
+
+template <typename SampleType>
+void SIMDChain<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    jassert(spec.numChannels <= lanes);
+
+    maximumBlockSize = spec.maximumBlockSize;
+
+    // one "channel" of registers, aligned for SIMDType
+    interleaved = juce::dsp::AudioBlock<SIMDType>(interleavedData, 1, maximumBlockSize);
+    std::fill_n(interleaved.getChannelPointer(0), maximumBlockSize, SIMDType::expand(SampleType(0)));
+
+    reset();
+}
+
+template <typename SampleType>
+void SIMDChain<SampleType>::reset()
+{
+    state.reset();
+}
+
+template <typename SampleType>
+void SIMDChain<SampleType>::process(const juce::dsp::AudioBlock<SampleType>& block, const CascadeCoefficients& cascade) noexcept
+{
+    jassert(block.getNumChannels() <= lanes);
+
+    auto numSamples = block.getNumSamples();
+
+    // hosts are allowed to go over the size they promised in prepareToPlay
+    for (size_t start = 0; start < numSamples; start += maximumBlockSize)
+    {
+        auto num = juce::jmin(maximumBlockSize, numSamples - start);
+
+        interleave(block, start, num);
+        processCascade(cascade, state, interleaved.getChannelPointer(0), num);
+        deinterleave(block, start, num);
+    }
+}
+
+template <typename SampleType>
+void SIMDChain<SampleType>::interleave(const juce::dsp::AudioBlock<SampleType>& block, size_t start, size_t num) noexcept
+{
+    auto* frames = reinterpret_cast<SampleType*>(interleaved.getChannelPointer(0));
+
+    for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+    {
+        auto* src = block.getChannelPointer(ch) + start;
+
+        for (size_t i = 0; i < num; ++i)
+            frames[i * lanes + ch] = src[i];
+    }
+
+    // lanes without a channel in this block would otherwise feed their own output back
+    // through the cascade block after block, and with a boost that runs away to inf
+    for (size_t ch = block.getNumChannels(); ch < lanes; ++ch)
+        for (size_t i = 0; i < num; ++i)
+            frames[i * lanes + ch] = SampleType(0);
+}
+
+template <typename SampleType>
+void SIMDChain<SampleType>::deinterleave(const juce::dsp::AudioBlock<SampleType>& block, size_t start, size_t num) noexcept
+{
+    auto* frames = reinterpret_cast<const SampleType*>(interleaved.getChannelPointer(0));
+
+    for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+    {
+        auto* dst = block.getChannelPointer(ch) + start;
+
+        for (size_t i = 0; i < num; ++i)
+            dst[i] = frames[i * lanes + ch];
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultiChannelChain<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    numChannels = spec.numChannels;
+
+    auto numGroups = (numChannels + Group::lanes - 1) / Group::lanes;
+
+    groups.clear();
+
+    for (size_t g = 0; g < numGroups; ++g)
+        groups.add(new Group());
+
+    for (int g = 0; g < groups.size(); ++g)
+    {
+        auto* group = groups.getUnchecked(g);
+        auto first = (size_t) g * Group::lanes;
+
+        juce::dsp::ProcessSpec groupSpec { spec.sampleRate, spec.maximumBlockSize,
+                                           (juce::uint32) juce::jmin(Group::lanes, numChannels - first) };
+
+        group->prepare(groupSpec);
+    }
+}
+
+template <typename SampleType>
+void MultiChannelChain<SampleType>::reset()
+{
+    for (auto* group : groups)
+        group->reset();
+}
+
+template <typename SampleType>
+void MultiChannelChain<SampleType>::process(const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    auto channels = juce::jmin(block.getNumChannels(), numChannels);
+
+    for (size_t first = 0, g = 0; first < channels; first += Group::lanes, ++g)
+    {
+        auto num = juce::jmin(Group::lanes, channels - first);
+        groups.getUnchecked((int) g)->process(block.getSubsetChannelBlock(first, num), cascade);
+    }
+}
+
+template class SIMDChain<float>;
+template class SIMDChain<double>;
+template class MultiChannelChain<float>;
+template class MultiChannelChain<double>;
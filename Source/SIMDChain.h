@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    Runs the filter chain once for several channels, one channel per SIMD lane.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+#include "CoefficientDesigner.h"
+#include "CascadeKernel.h"
+
+// Interleaves up to SIMDRegister<SampleType>::size() channels into the lanes of one register stream and
+// runs LowCut -> Peak -> HighCut a single time for all of them, instead of once per channel.
+//
+// Every lane does exactly the same operations in the same order as the scalar IIR::Filter,
+// so with the same coefficients the output matches two MonoChains to within 1e-6. The only difference
+// is that the scalar filter flushes state below 1e-8 to zero at the end of a block and the
+// SIMD path doesn't, which only shows up once a signal has decayed to that level.
+//
+// SampleType is float or double, the latter having half as many lanes.
+template <typename SampleType>
+class SIMDChain
+{
+public:
+    using SIMDType = juce::dsp::SIMDRegister<SampleType>;
+
+    static constexpr size_t lanes = SIMDType::SIMDNumElements;
+
+    // spec.numChannels is the number of channels actually used, at most `lanes`
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    // block may have fewer channels than the chain was prepared for, but not more
+    void process(const juce::dsp::AudioBlock<SampleType>& block, const CascadeCoefficients& cascade) noexcept;
+
+private:
+    void interleave(const juce::dsp::AudioBlock<SampleType>& block, size_t start, size_t num) noexcept;
+    void deinterleave(const juce::dsp::AudioBlock<SampleType>& block, size_t start, size_t num) noexcept;
+
+    CascadeState<SIMDType> state;
+
+    juce::HeapBlock<char> interleavedData;
+    juce::dsp::AudioBlock<SIMDType> interleaved;
+    size_t maximumBlockSize {0};
+};
+
+//==============================================================================
+// Any number of channels (surround, ambisonics...), processed in groups of SIMDChain::lanes.
+// The groups only hold filter state; there is a single set of coefficients for all of them,
+// so a new set is copied once no matter how many channels there are.
+template <typename SampleType>
+class MultiChannelChain
+{
+public:
+    // sizes the groups from spec.numChannels. Allocates, so prepareToPlay only.
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    void setCoefficients(const FilterCoefficients& c) noexcept { makeCascade(c, cascade); }
+
+    // swaps in another section for the Peak band, e.g. a dynamic one. Until the next setCoefficients.
+    void setPeakSection(const SectionCoefficients& section) noexcept
+    {
+        if (cascade.peakSection >= 0)
+            cascade.sections[(size_t) cascade.peakSection] = section;
+    }
+
+    void process(const juce::dsp::AudioBlock<SampleType>& block) noexcept;
+
+    size_t getNumChannels() const noexcept { return numChannels; }
+    int getNumSections() const noexcept { return cascade.numSections; }
+
+private:
+    using Group = SIMDChain<SampleType>;
+
+    CascadeCoefficients cascade;
+    juce::OwnedArray<Group> groups;
+    size_t numChannels {0};
+};
@@ -0,0 +1,161 @@
+/*
+  ==============================================================================
+
+    Pre / post EQ spectrum, analysed on a background thread.
+
+  ==============================================================================
+*/
+
+#include "SpectrumAnalyzer.h"
+
+// how much of each new frame goes into the running average, per FFT
+static constexpr float averagingFactor = 0.25f;
+
+SpectrumAnalyzer::SpectrumAnalyzer(juce::AudioProcessor& p, AnalyzerFifo& preEq, AnalyzerFifo& postEq)
+    : processor(p), pre(preEq), post(postEq)
+{
+    thread->addTimeSliceClient(this);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+    // waits for a running slice to finish
+    thread->removeTimeSliceClient(this);
+}
+
+void SpectrumAnalyzer::setArea(juce::Rectangle<float> newArea)
+{
+    const juce::ScopedLock sl(lock);
+    area = newArea;
+}
+
+void SpectrumAnalyzer::fetchPaths(juce::Path& prePath, juce::Path& postPath)
+{
+    const juce::ScopedLock sl(lock);
+    prePath.swapWithPath(pre.readyPath);
+    postPath.swapWithPath(post.readyPath);
+}
+
+int SpectrumAnalyzer::useTimeSlice()
+{
+    auto sampleRate = processor.getSampleRate();
+
+    if(sampleRate <= 0)
+        return 50;
+
+    auto changed = analyse(pre);
+    changed = analyse(post) || changed;
+
+    if(! changed)
+        return 10;
+
+    juce::Rectangle<float> currentArea;
+
+    {
+        const juce::ScopedLock sl(lock);
+        currentArea = area;
+    }
+
+    makePath(pre, currentArea, sampleRate);
+    makePath(post, currentArea, sampleRate);
+
+    {
+        const juce::ScopedLock sl(lock);
+        pre.readyPath.swapWithPath(pre.path);
+        post.readyPath.swapWithPath(post.path);
+    }
+
+    ++generation;
+    return 10;
+}
+
+// drains the fifo into the history, running an FFT every hopSize samples
+bool SpectrumAnalyzer::analyse(Channel& c)
+{
+    auto analysed = false;
+
+    for (;;)
+    {
+        auto numPulled = c.fifo.pull(scratch.data(), hopSize - c.samplesSinceLastFFT);
+
+        for (int i = 0; i < numPulled; ++i)
+        {
+            c.history[(size_t) c.historyPosition] = scratch[(size_t) i];
+            c.historyPosition = (c.historyPosition + 1) % fftSize;
+        }
+
+        c.samplesSinceLastFFT += numPulled;
+
+        if(c.samplesSinceLastFFT < hopSize)
+            return analysed;
+
+        c.samplesSinceLastFFT = 0;
+        runFFT(c);
+        analysed = true;
+    }
+}
+
+void SpectrumAnalyzer::runFFT(Channel& c)
+{
+    // unroll the ring so the oldest sample comes first
+    auto oldest = c.history.begin() + c.historyPosition;
+    std::copy(oldest, c.history.end(), c.fftData.begin());
+    std::copy(c.history.begin(), oldest, c.fftData.begin() + (fftSize - c.historyPosition));
+
+    window.multiplyWithWindowingTable(c.fftData.data(), (size_t) fftSize);
+    fft.performFrequencyOnlyForwardTransform(c.fftData.data());
+
+    // a full scale sine comes out of a Hann windowed FFT with magnitude fftSize / 4
+    const auto scale = 4.0f / (float) fftSize;
+
+    for (size_t bin = 0; bin < c.averagePower.size(); ++bin)
+    {
+        auto magnitude = c.fftData[bin] * scale;
+        auto& average = c.averagePower[bin];
+        average += averagingFactor * (magnitude * magnitude - average);
+    }
+}
+
+void SpectrumAnalyzer::makePath(Channel& c, juce::Rectangle<float> pathArea, double sampleRate)
+{
+    c.path.clear();
+
+    auto width = (int) pathArea.getWidth();
+
+    if(width <= 0)
+        return;
+
+    const auto binsPerHz = fftSize / sampleRate;
+    const auto lastBin = (int) c.averagePower.size() - 1;
+
+    auto powerAt = [&](double bin)
+    {
+        // between two bins at the low end, interpolate
+        auto i = juce::jlimit(0, lastBin - 1, (int) bin);
+        auto frac = (float) juce::jlimit(0.0, 1.0, bin - i);
+        return c.averagePower[(size_t) i] + frac * (c.averagePower[(size_t) i + 1] - c.averagePower[(size_t) i]);
+    };
+
+    for (int x = 0; x <= width; ++x)
+    {
+        auto lowBin = juce::mapToLog10((double) x / width, 20.0, 20000.0) * binsPerHz;
+        auto highBin = juce::mapToLog10((double) (x + 1) / width, 20.0, 20000.0) * binsPerHz;
+
+        auto first = (int) std::ceil(lowBin);
+        auto last = juce::jmin(lastBin, (int) std::floor(highBin));
+        auto power = powerAt(lowBin);
+
+        // several bins per pixel at the top end, show the loudest
+        for (auto bin = first; bin <= last; ++bin)
+            power = juce::jmax(power, c.averagePower[(size_t) bin]);
+
+        auto decibels = 10.0f * std::log10(juce::jmax(power, 1.0e-12f));
+        auto y = juce::jmap(juce::jlimit(minDecibels, maxDecibels, decibels), minDecibels, maxDecibels,
+                            pathArea.getBottom(), pathArea.getY());
+
+        if(x == 0)
+            c.path.startNewSubPath(pathArea.getX(), y);
+        else
+            c.path.lineTo(pathArea.getX() + (float) x, y);
+    }
+}
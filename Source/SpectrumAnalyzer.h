@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    Pre / post EQ spectrum, analysed on a background thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AnalyzerFifo.h"
+
+// Pulls the pre and post EQ mono mixes out of their fifos, runs a Hann windowed FFT every
+// hop, averages the power per bin and turns it into a Path for the analysis area. All of
+// that happens on a shared background thread, the GUI only swaps the finished paths in
+// and strokes them.
+//
+// x maps 20 Hz .. 20 kHz on a log scale like the response curve, y maps minDecibels ..
+// maxDecibels, which is the second (left hand) scale the response curve draws.
+class SpectrumAnalyzer : private juce::TimeSliceClient
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 2;
+    static constexpr float minDecibels = -48.0f, maxDecibels = 0.0f;
+
+    SpectrumAnalyzer(juce::AudioProcessor& processor, AnalyzerFifo& preEq, AnalyzerFifo& postEq);
+    ~SpectrumAnalyzer() override;
+
+    // GUI thread: the area to draw into, in the component's coordinates
+    void setArea(juce::Rectangle<float> area);
+
+    // bumped every time new paths are ready
+    juce::uint32 getGeneration() const noexcept { return generation.load(); }
+
+    // GUI thread: swaps the latest paths into pre / post. Nothing is copied or allocated,
+    // the old paths go back to the analyzer to be refilled.
+    void fetchPaths(juce::Path& pre, juce::Path& post);
+
+private:
+    struct Channel
+    {
+        explicit Channel(AnalyzerFifo& f) : fifo(f) {}
+
+        AnalyzerFifo& fifo;
+
+        std::vector<float> history = std::vector<float>(fftSize);       // ring buffer of the last fftSize samples
+        int historyPosition {0};
+        int samplesSinceLastFFT {0};
+
+        std::vector<float> fftData = std::vector<float>(fftSize * 2);
+        std::vector<float> averagePower = std::vector<float>(fftSize / 2 + 1);
+
+        juce::Path path, readyPath;
+    };
+
+    int useTimeSlice() override;
+
+    bool analyse(Channel&);
+    void runFFT(Channel&);
+    void makePath(Channel&, juce::Rectangle<float> area, double sampleRate);
+
+    struct AnalyzerThread : juce::TimeSliceThread
+    {
+        AnalyzerThread() : juce::TimeSliceThread("SimpleEQ analyzer") { startThread(); }
+        ~AnalyzerThread() override { stopThread(1000); }
+    };
+
+    juce::AudioProcessor& processor;
+    Channel pre, post;
+
+    juce::dsp::FFT fft {fftOrder};
+    juce::dsp::WindowingFunction<float> window {(size_t) fftSize, juce::dsp::WindowingFunction<float>::hann, false};
+    std::vector<float> scratch = std::vector<float>(hopSize);
+
+    juce::CriticalSection lock;                         // area and ready paths, analyzer vs GUI only
+    juce::Rectangle<float> area;
+
+    std::atomic<juce::uint32> generation {0};
+
+    juce::SharedResourcePointer<AnalyzerThread> thread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAnalyzer)
+};
@@ -0,0 +1,1264 @@
+/*
+  ==============================================================================
+
+    SimpleEQBench: timings for processBlock and the coefficient design helpers.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include "../../../Source/BiquadMath.h"
+#include "../../../Source/CoefficientTables.h"
+
+// Times SimpleEQAudioProcessor::processBlock in ns per sample (per channel) for every
+// combination of cut slopes and band bypasses, over a range of block sizes and sample rates,
+// and the design helpers from FilterChain.h in ns per call. Results go out as JSON so they
+// can be kept and diffed between releases. Also times the cost per peak band, prepares a
+// pile of identical instances to see what the shared coefficient cache saves, session load
+// from the binary state and preset banks, and more.
+//
+//  SimpleEQBench [--out results.json] [--quick] [--samples n]
+//
+// --quick only runs 64 / 512 sample blocks at 48k, for a fast sanity check.
+//
+//  SimpleEQBench --verify [--baseline earlier.json] [--golden dir [--update-golden]] ...
+//
+// checks the measured response against a reference model, renders against golden files and
+// throughput against an earlier run instead, and exits with 1 if any of it fails. See runVerify.
+
+namespace
+{
+volatile double sink = 0; // keeps the optimiser from throwing away the work we're timing
+
+struct BenchConfig
+{
+    Slope lowCutSlope {Slope_12}, highCutSlope {Slope_12};
+    bool lowCutBypassed {false}, peakBypassed {false}, highCutBypassed {false};
+};
+
+void setParameter(SimpleEQAudioProcessor& processor, const juce::String& paramID, float value)
+{
+    auto* param = processor.apvts.getParameter(paramID);
+    jassert(param != nullptr);
+    param->setValueNotifyingHost(param->convertTo0to1(value));
+}
+
+void applyConfig(SimpleEQAudioProcessor& processor, const BenchConfig& config)
+{
+    // a peak that actually does something and cuts well inside the audio band
+    setParameter(processor, "LowCut Freq", 80.0f);
+    setParameter(processor, "HighCut Freq", 12000.0f);
+    setParameter(processor, "Peak Freq", 1000.0f);
+    setParameter(processor, "Peak Gain", 6.0f);
+    setParameter(processor, "Peak Q", 1.0f);
+
+    setParameter(processor, "LowCut Slope", (float) config.lowCutSlope);
+    setParameter(processor, "HighCut Slope", (float) config.highCutSlope);
+    setParameter(processor, "LowCut Bypassed", config.lowCutBypassed ? 1.0f : 0.0f);
+    setParameter(processor, "Peak Bypassed", config.peakBypassed ? 1.0f : 0.0f);
+    setParameter(processor, "HighCut Bypassed", config.highCutBypassed ? 1.0f : 0.0f);
+}
+
+// best of a few runs, the minimum is the least noisy estimate on a busy machine
+template <typename Function>
+double bestOf(int runs, Function&& f)
+{
+    auto best = std::numeric_limits<double>::max();
+
+    for (int r = 0; r < runs; ++r)
+    {
+        auto start = juce::Time::getHighResolutionTicks();
+        f();
+        auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        best = juce::jmin(best, seconds);
+    }
+
+    return best;
+}
+
+// buffer is only scratch space for one block. Every block starts from untouched noise, read
+// from a source that's advanced through, otherwise each block would filter the last one's
+// output again and a boosted band would run away to inf within a run. The copy is timed too,
+// it's what a host does anyway and is small next to the chain.
+double timeProcessBlock(SimpleEQAudioProcessor& processor, juce::AudioBuffer<float>& buffer,
+                        double sampleRate, int blockSize, int numSamples, bool* outputIsFinite = nullptr)
+{
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    auto numBlocks = juce::jmax(1, numSamples / blockSize);
+    juce::AudioBuffer<float> source (buffer.getNumChannels(), numBlocks * blockSize);
+
+    juce::Random random (1234);
+
+    for (int ch = 0; ch < source.getNumChannels(); ++ch)
+        for (int i = 0; i < source.getNumSamples(); ++i)
+            source.setSample(ch, i, random.nextFloat() * 0.5f - 0.25f);
+
+    juce::MidiBuffer midi;
+
+    auto run = [&]
+    {
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.copyFrom(ch, 0, source, ch, b * blockSize, blockSize);
+
+            juce::AudioBuffer<float> block (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), blockSize);
+            processor.processBlock(block, midi);
+        }
+    };
+
+    run(); // warm up
+    auto seconds = bestOf(5, run);
+
+    // a chain that has blown up keeps producing inf or NaN, so the last block is enough to tell
+    if(outputIsFinite != nullptr)
+    {
+        *outputIsFinite = true;
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                if(! std::isfinite(buffer.getSample(ch, i)))
+                    *outputIsFinite = false;
+    }
+
+    processor.releaseResources();
+
+    return seconds * 1.0e9 / ((double) numBlocks * blockSize);
+}
+
+// processBlock cost against the number of peak bands in use, cuts at 12 dB/oct, so the
+// slope of nsPerSample over "bands" is the cost of one more band
+juce::Array<juce::var> benchBands(SimpleEQAudioProcessor& processor, juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    juce::Array<juce::var> results;
+
+    applyConfig(processor, BenchConfig());
+
+    for (int band = 1; band < MaxPeakBands; ++band)
+    {
+        setParameter(processor, getPeakParameterID(band, "Gain"), band % 2 == 0 ? 3.0f : -3.0f);
+        setParameter(processor, getPeakParameterID(band, "Q"), 2.0f);
+    }
+
+    for (int numBands = 1; numBands <= MaxPeakBands; ++numBands)
+    {
+        setParameter(processor, "Peak Bands", (float) (numBands - 1));
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty("bands", numBands);
+        result->setProperty("nsPerSample", timeProcessBlock(processor, buffer, 48000.0, 512, numSamples)
+                                               / processor.getMainBusNumInputChannels());
+        results.add(juce::var(result));
+    }
+
+    setParameter(processor, "Peak Bands", 0.0f);
+    return results;
+}
+
+// The Peak band static and dynamic, at a small and a large block. The noise from
+// timeProcessBlock is well over the threshold, so the dynamic band is working the whole time.
+juce::Array<juce::var> benchDynamic(SimpleEQAudioProcessor& processor, juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    juce::Array<juce::var> results;
+
+    applyConfig(processor, BenchConfig());
+    setParameter(processor, "Peak Threshold", -40.0f);
+    setParameter(processor, "Peak Ratio", 4.0f);
+
+    // a low band's detector runs 16x decimated, one above 1.5 kHz every sample
+    for (auto peakFreq : { 150.0f, 3000.0f })
+    {
+        setParameter(processor, "Peak Freq", peakFreq);
+
+        for (auto dynamic : { false, true })
+        {
+            setParameter(processor, "Peak Dynamic", dynamic ? 1.0f : 0.0f);
+
+            for (auto blockSize : { 64, 512 })
+            {
+                auto* result = new juce::DynamicObject();
+                result->setProperty("peakFreq", peakFreq);
+                result->setProperty("dynamic", dynamic);
+                result->setProperty("blockSize", blockSize);
+                result->setProperty("nsPerSample", timeProcessBlock(processor, buffer, 48000.0, blockSize, numSamples)
+                                                       / processor.getMainBusNumInputChannels());
+                results.add(juce::var(result));
+            }
+        }
+    }
+
+    setParameter(processor, "Peak Dynamic", 0.0f);
+    setParameter(processor, "Peak Freq", 1000.0f);
+    return results;
+}
+
+// What a track costs depending on what's on it. Silent tracks should go idle once the filters
+// have rung out and cost next to nothing, quiet noise (-120 dB, above the idle threshold) runs
+// the full chain with tiny filter states, and subnormal noise checks that denormals don't
+// cost extra on the way to idle. Each block is refilled from the same source, so every
+// signal pays the same copy.
+juce::Array<juce::var> benchSignals(SimpleEQAudioProcessor& processor, int numSamples)
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+
+    struct Signal { const char* name; float amplitude; };
+    juce::Array<juce::var> results;
+
+    const auto numChannels = processor.getMainBusNumInputChannels();
+    juce::AudioBuffer<float> source (numChannels, blockSize), block (numChannels, blockSize);
+    juce::MidiBuffer midi;
+
+    for (auto signal : { Signal { "noise", 0.25f }, Signal { "quietNoise", 1.0e-6f },
+                         Signal { "subnormalNoise", 1.0e-40f }, Signal { "silence", 0.0f } })
+    {
+        juce::Random random (1234);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                source.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * signal.amplitude);
+
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        auto numBlocks = juce::jmax(1, numSamples / blockSize);
+
+        auto run = [&]
+        {
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                block.makeCopyOf(source, true);
+                processor.processBlock(block, midi);
+            }
+        };
+
+        run(); // also long enough for the tail to ring out, like a track that's been quiet a while
+
+        auto idleBefore = processor.getNumIdleBlocks();
+        auto seconds = bestOf(5, run);
+        auto idleBlocks = processor.getNumIdleBlocks() - idleBefore;
+
+        processor.releaseResources();
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty("signal", signal.name);
+        result->setProperty("nsPerSample", seconds * 1.0e9 / ((double) numBlocks * blockSize) / numChannels);
+        result->setProperty("idleFraction", (double) idleBlocks / (5.0 * numBlocks));
+        results.add(juce::var(result));
+    }
+
+    return results;
+}
+
+template <typename Function>
+double timePerCall(int numCalls, Function&& f)
+{
+    return bestOf(5, [&] { for (int i = 0; i < numCalls; ++i) f(i); }) * 1.0e9 / numCalls;
+}
+
+juce::var makeDesignResult(const juce::String& name, int slope, double nsPerCall)
+{
+    auto* result = new juce::DynamicObject();
+    result->setProperty("name", name);
+
+    if(slope >= 0)
+        result->setProperty("slope", (12 * (slope + 1)));
+
+    result->setProperty("nsPerCall", nsPerCall);
+    return juce::var(result);
+}
+
+// How the processor loaded a cut band before the fused cascade: coefficients copied stage by
+// stage into a juce ProcessorChain. Only kept as the baseline for benchDesign.
+template <int Index, typename CoefficientType>
+void updateCutStage(CutFilter& cutFilter, const CoefficientType& cutCoefficients)
+{
+    *cutFilter.get<Index>().coefficients = *cutCoefficients[Index];
+    cutFilter.setBypassed<Index>(false);
+}
+
+template <typename CoefficientType>
+void updateCutFilter(CutFilter& cutFilter, const CoefficientType& cutCoefficients, Slope slope)
+{
+    cutFilter.setBypassed<0>(true);
+    cutFilter.setBypassed<1>(true);
+    cutFilter.setBypassed<2>(true);
+    cutFilter.setBypassed<3>(true);
+
+    switch(slope)
+    {
+        case Slope_48: updateCutStage<3>(cutFilter, cutCoefficients); [[fallthrough]];
+        case Slope_36: updateCutStage<2>(cutFilter, cutCoefficients); [[fallthrough]];
+        case Slope_24: updateCutStage<1>(cutFilter, cutCoefficients); [[fallthrough]];
+        case Slope_12: updateCutStage<0>(cutFilter, cutCoefficients);
+    }
+}
+
+juce::Array<juce::var> benchDesign(double sampleRate)
+{
+    constexpr int numCalls = 20000;
+    juce::Array<juce::var> results;
+
+    ChainSettings cs;
+    cs.peakFreq = 1000.0f;
+    cs.peakGainInDecibels = 6.0f;
+    cs.peakQ = 1.0f;
+    cs.lowCutFreq = 80.0f;
+    cs.highCutFreq = 12000.0f;
+
+    // nudge the frequency every call so nothing can be hoisted out of the loop
+    auto nudge = [](float f, int i) { return f * (1.0f + 0.0001f * (float) (i & 15)); };
+
+    results.add(makeDesignResult("makePeakFilter", -1, timePerCall(numCalls, [&](int i)
+    {
+        auto s = cs;
+        s.peakFreq = nudge(cs.peakFreq, i);
+        sink = sink + makePeakFilter(s, sampleRate)->coefficients[0];
+    })));
+
+    for (int slope = Slope_12; slope <= Slope_48; ++slope)
+    {
+        cs.lowCutSlope = cs.highCutSlope = static_cast<Slope>(slope);
+
+        results.add(makeDesignResult("makeLowCutFilter", slope, timePerCall(numCalls, [&](int i)
+        {
+            auto s = cs;
+            s.lowCutFreq = nudge(cs.lowCutFreq, i);
+            sink = sink + makeLowCutFilter(s, sampleRate)[0]->coefficients[0];
+        })));
+
+        results.add(makeDesignResult("makeHighCutFilter", slope, timePerCall(numCalls, [&](int i)
+        {
+            auto s = cs;
+            s.highCutFreq = nudge(cs.highCutFreq, i);
+            sink = sink + makeHighCutFilter(s, sampleRate)[0]->coefficients[0];
+        })));
+
+        // just the copy into the chain, the design is done once up front
+        CutFilter cutFilter;
+        auto lowCutCoefficients = makeLowCutFilter(cs, sampleRate);
+
+        results.add(makeDesignResult("updateCutFilter", slope, timePerCall(numCalls, [&](int)
+        {
+            updateCutFilter(cutFilter, lowCutCoefficients, cs.lowCutSlope);
+            sink = sink + cutFilter.get<0>().coefficients->coefficients[0];
+        })));
+    }
+
+    // and what the designer thread actually runs: every band, in double, in one go
+    results.add(makeDesignResult("designCoefficients", -1, timePerCall(numCalls / 4, [&](int i)
+    {
+        auto s = cs;
+        s.peakFreq = nudge(cs.peakFreq, i);
+        sink = sink + designCoefficients(s, sampleRate)->peak[0];
+    })));
+
+    // the audio thread's redesigns while smoothing: trig per call vs the shared tables
+    CoefficientTables tables;
+
+    results.add(makeDesignResult("makePeakSection", -1, timePerCall(numCalls, [&](int i)
+    {
+        sink = sink + makePeakSection(sampleRate, (double) nudge(cs.peakFreq, i), 1.0, 2.0)[0];
+    })));
+
+    results.add(makeDesignResult("CoefficientTables::makePeakSection", -1, timePerCall(numCalls, [&](int i)
+    {
+        sink = sink + tables.makePeakSection(sampleRate, (double) nudge(cs.peakFreq, i), 1.0, 6.0)[0];
+    })));
+
+    std::array<SectionCoefficients, 4> sections;
+
+    results.add(makeDesignResult("makeCutSections", Slope_48, timePerCall(numCalls, [&](int i)
+    {
+        sink = sink + makeCutSections(true, sampleRate, (double) nudge(cs.lowCutFreq, i), Slope_48, sections);
+    })));
+
+    results.add(makeDesignResult("CoefficientTables::makeCutSections", Slope_48, timePerCall(numCalls, [&](int i)
+    {
+        sink = sink + tables.makeCutSections(true, sampleRate, (double) nudge(cs.lowCutFreq, i), Slope_48, sections);
+    })));
+
+    return results;
+}
+
+// |H(w)| of one section in dB
+double getSectionDecibels(const SectionCoefficients& c, double w)
+{
+    std::complex<double> z = std::polar(1.0, -w);
+    auto h = (c[0] + c[1] * z + c[2] * z * z) / (1.0 + c[3] * z + c[4] * z * z);
+    return juce::Decibels::gainToDecibels(std::abs(h), -300.0);
+}
+
+// worst magnitude response difference between the table driven designs and the exact
+// ones over the parameter ranges, the figure CoefficientTables.h promises
+juce::var benchTableAccuracy(bool quick)
+{
+    CoefficientTables tables;
+    double worstPeak = 0, worstCut = 0;
+
+    auto frequencyStep = quick ? 1.1 : 1.02;
+    constexpr int numTestFrequencies = 128;
+
+    for (auto sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 })
+    {
+        for (double frequency = 20.0; frequency <= 20000.0; frequency *= frequencyStep)
+        {
+            auto testAt = [&](auto&& getDifference)
+            {
+                auto worst = 0.0;
+
+                for (int k = 1; k < numTestFrequencies; ++k)
+                    worst = juce::jmax(worst, getDifference(juce::MathConstants<double>::pi * k / numTestFrequencies));
+
+                return worst;
+            };
+
+            for (auto Q : { 0.1, 0.5, 1.0, 3.0, 10.0 })
+            {
+                for (auto gain : { -24.0, -11.75, 0.25, 6.0, 17.25, 24.0 })
+                {
+                    auto table = tables.makePeakSection(sampleRate, frequency, Q, gain);
+                    auto exact = makePeakSection(sampleRate, frequency, Q, juce::Decibels::decibelsToGain(gain));
+
+                    worstPeak = juce::jmax(worstPeak, testAt([&](double w)
+                    {
+                        return std::abs(getSectionDecibels(table, w) - getSectionDecibels(exact, w));
+                    }));
+                }
+            }
+
+            for (int slope = Slope_12; slope <= Slope_48; ++slope)
+            {
+                for (auto isHighPass : { false, true })
+                {
+                    std::array<SectionCoefficients, 4> table, exact;
+                    auto numSections = tables.makeCutSections(isHighPass, sampleRate, frequency, static_cast<Slope>(slope), table);
+                    makeCutSections(isHighPass, sampleRate, frequency, static_cast<Slope>(slope), exact);
+
+                    worstCut = juce::jmax(worstCut, testAt([&](double w)
+                    {
+                        auto tableDecibels = 0.0, exactDecibels = 0.0;
+
+                        for (int i = 0; i < numSections; ++i)
+                        {
+                            tableDecibels += getSectionDecibels(table[(size_t) i], w);
+                            exactDecibels += getSectionDecibels(exact[(size_t) i], w);
+                        }
+
+                        // deep in the stop band the relative error means nothing
+                        return exactDecibels > -60.0 ? std::abs(tableDecibels - exactDecibels) : 0.0;
+                    }));
+                }
+            }
+        }
+    }
+
+    auto* result = new juce::DynamicObject();
+    result->setProperty("maxPeakErrorDb", worstPeak);
+    result->setProperty("maxCutErrorDb", worstCut);
+    return juce::var(result);
+}
+
+// what the shared coefficient cache buys a big session: a lot of instances with the same
+// settings preparing at one rate and then another. The first instance at each rate designs,
+// the rest should hit.
+juce::var benchInstances(int numInstances)
+{
+    juce::OwnedArray<SimpleEQAudioProcessor> instances;
+
+    BenchConfig config;
+    config.lowCutSlope = config.highCutSlope = Slope_48;
+
+    for (int i = 0; i < numInstances; ++i)
+        applyConfig(*instances.add(new SimpleEQAudioProcessor()), config);
+
+    auto before = instances[0]->getCoefficientCacheStatistics();
+    auto start = juce::Time::getHighResolutionTicks();
+
+    for (auto sampleRate : { 44100.0, 96000.0 })
+    {
+        for (auto* instance : instances)
+        {
+            instance->setRateAndBufferSizeDetails(sampleRate, 512);
+            instance->prepareToPlay(sampleRate, 512);
+        }
+    }
+
+    auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+    auto after = instances[0]->getCoefficientCacheStatistics();
+
+    auto hits = after.hits - before.hits;
+    auto misses = after.misses - before.misses;
+
+    auto* result = new juce::DynamicObject();
+    result->setProperty("instances", numInstances);
+    result->setProperty("msPerPrepare", seconds * 1000.0 / (2.0 * numInstances));
+    result->setProperty("cacheHits", (juce::int64) hits);
+    result->setProperty("cacheMisses", (juce::int64) misses);
+    result->setProperty("cacheHitRate", hits + misses > 0 ? (double) hits / (double) (hits + misses) : 0.0);
+    return juce::var(result);
+}
+
+// Session load: restoring a lot of instances from the binary state against the old ValueTree
+// state with the same values, and a bank of presets being opened, listed and applied.
+juce::var benchState(int numInstances, int numPresets)
+{
+    juce::OwnedArray<SimpleEQAudioProcessor> instances;
+
+    for (int i = 0; i < numInstances; ++i)
+        instances.add(new SimpleEQAudioProcessor());
+
+    auto& source = *instances[0];
+    BenchConfig config;
+    config.lowCutSlope = Slope_24;
+    applyConfig(source, config);
+    setParameter(source, "Peak Bands", 3.0f);
+
+    juce::MemoryBlock binary, legacy;
+    source.getStateInformation(binary);
+
+    {
+        juce::MemoryOutputStream mos(legacy, false);
+        source.apvts.state.writeToStream(mos);
+    }
+
+    auto timeRestore = [&] (const juce::MemoryBlock& state)
+    {
+        // from defaults every time, so each restore changes the same parameters
+        for (auto* instance : instances)
+            for (auto* param : instance->getParameters())
+                param->setValueNotifyingHost(param->getDefaultValue());
+
+        auto start = juce::Time::getHighResolutionTicks();
+
+        for (auto* instance : instances)
+            instance->setStateInformation(state.getData(), (int) state.getSize());
+
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+    };
+
+    auto binarySeconds = timeRestore(binary);
+    auto legacySeconds = timeRestore(legacy);
+
+    // a bank of presets that only differ in the peak, written once and then mapped
+    juce::Array<PresetBank::Preset> presets;
+    BinaryState state (source.apvts);
+
+    for (int i = 0; i < numPresets; ++i)
+    {
+        setParameter(source, "Peak Freq", 100.0f + (float) (i % 1000) * 15.0f);
+        setParameter(source, "Peak Gain", (float) (i % 49) - 24.0f);
+
+        PresetBank::Preset preset;
+        preset.name = "Preset " + juce::String(i + 1);
+        state.write(preset.state);
+        presets.add(preset);
+    }
+
+    juce::TemporaryFile bankFile (".seqbank");
+    PresetBank::write(bankFile.getFile(), presets);
+
+    auto start = juce::Time::getHighResolutionTicks();
+
+    PresetBank bank;
+    bank.open(bankFile.getFile());
+
+    for (int i = 0; i < bank.getNumPresets(); ++i)
+        sink = sink + bank.getName(i).length();
+
+    auto listSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+    start = juce::Time::getHighResolutionTicks();
+
+    for (int i = 0; i < bank.getNumPresets(); ++i)
+        bank.apply(i, state);
+
+    auto applySeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+    auto* result = new juce::DynamicObject();
+    result->setProperty("instances", numInstances);
+    result->setProperty("binaryBytes", (int) binary.getSize());
+    result->setProperty("valueTreeBytes", (int) legacy.getSize());
+    result->setProperty("usPerBinaryRestore", binarySeconds * 1.0e6 / numInstances);
+    result->setProperty("usPerValueTreeRestore", legacySeconds * 1.0e6 / numInstances);
+    result->setProperty("presets", bank.getNumPresets());
+    result->setProperty("msToOpenAndList", listSeconds * 1000.0);
+    result->setProperty("usPerPresetApply", bank.getNumPresets() > 0 ? applySeconds * 1.0e6 / bank.getNumPresets() : 0.0);
+    return juce::var(result);
+}
+
+//==============================================================================
+// --verify: checks instead of timings, with a pass / fail exit code, so an optimisation can
+// show it is both faster and gives the same results.
+//
+//  - response: an impulse goes through prepareToPlay / processBlock (float and double) for
+//    configurations across the parameter space, and the magnitude of the impulse response at
+//    64 frequencies is compared with the analytic response of juce's own designs
+//    (IIR::Coefficients::getMagnitudeForFrequency), the reference model. For the float chain
+//    the reference coefficients are rounded to float first: a low, narrow section at a high
+//    rate is a slightly different filter in float, and that's not what's being checked here.
+//    Levels below floorDb count as floorDb on both sides. Every channel has to match the first.
+//  - golden: noise rendered through a few fixed configurations against WAV files in a
+//    directory, written there by --update-golden.
+//  - throughput: ns per sample for a few configurations, compared with an earlier
+//    --verify --out file given as --baseline.
+//
+// Linear phase is only in golden: its response is a windowed FIR of the same curve, so it
+// doesn't match the reference model to these tolerances.
+struct Tolerances
+{
+    double floatDb {0.1}, doubleDb {0.01};
+    double oversampledDb {0.25};            // the half band filters ripple a little
+    double floorDb {-80.0};
+    double golden {1.0e-5};                 // largest sample difference
+    double maxSlowdown {1.25};              // against the baseline
+};
+
+using ParameterSettings = juce::Array<std::pair<juce::String, float>>;
+
+struct VerifyConfig
+{
+    juce::String name;
+    double sampleRate;
+    ParameterSettings settings;
+};
+
+void applySettings(SimpleEQAudioProcessor& processor, const ParameterSettings& settings)
+{
+    // from the defaults, so a configuration doesn't inherit anything from the one before
+    for (auto* param : processor.getParameters())
+        param->setValueNotifyingHost(param->getDefaultValue());
+
+    for (const auto& s : settings)
+        setParameter(processor, s.first, s.second);
+}
+
+juce::Array<VerifyConfig> makeResponseConfigs(bool quick)
+{
+    juce::Array<VerifyConfig> configs;
+
+    for (int lowCutSlope = Slope_12; lowCutSlope <= Slope_48; ++lowCutSlope)
+        for (int highCutSlope = Slope_12; highCutSlope <= Slope_48; ++highCutSlope)
+            configs.add({ "slopes " + juce::String(lowCutSlope) + "/" + juce::String(highCutSlope), 48000.0,
+                          { { "LowCut Freq", 80.0f }, { "HighCut Freq", 12000.0f }, { "Peak Gain", 6.0f },
+                            { "LowCut Slope", (float) lowCutSlope }, { "HighCut Slope", (float) highCutSlope } } });
+
+    for (int bypassed = 0; bypassed < 8; ++bypassed)
+        configs.add({ "bypass " + juce::String(bypassed), 44100.0,
+                      { { "LowCut Freq", 200.0f }, { "HighCut Freq", 5000.0f }, { "Peak Gain", -9.0f },
+                        { "LowCut Slope", 1.0f }, { "HighCut Slope", 2.0f },
+                        { "LowCut Bypassed", (float) (bypassed & 1) }, { "Peak Bypassed", (float) ((bypassed >> 1) & 1) },
+                        { "HighCut Bypassed", (float) ((bypassed >> 2) & 1) } } });
+
+    auto sampleRates = quick ? juce::Array<double> { 48000.0 } : juce::Array<double> { 44100.0, 96000.0, 192000.0 };
+
+    for (auto sampleRate : sampleRates)
+        for (auto freq : { 100.0f, 1000.0f, 15000.0f })
+            for (auto gain : { -24.0f, 6.0f, 24.0f })
+                for (auto q : { 0.1f, 1.0f, 10.0f })
+                    configs.add({ "peak " + juce::String(freq) + " Hz " + juce::String(gain) + " dB Q " + juce::String(q),
+                                  sampleRate, { { "Peak Freq", freq }, { "Peak Gain", gain }, { "Peak Q", q } } });
+
+    // every peak band in use, settings from a fixed seed
+    {
+        juce::Random random (42);
+        ParameterSettings settings { { "Peak Bands", (float) (MaxPeakBands - 1) } };
+
+        for (int band = 0; band < MaxPeakBands; ++band)
+        {
+            settings.add({ getPeakParameterID(band, "Freq"), juce::mapToLog10(random.nextFloat(), 40.0f, 16000.0f) });
+            settings.add({ getPeakParameterID(band, "Gain"), std::round(random.nextFloat() * 24.0f - 12.0f) });
+            settings.add({ getPeakParameterID(band, "Q"), 0.5f + random.nextFloat() * 3.0f });
+        }
+
+        configs.add({ "16 bands", 48000.0, settings });
+    }
+
+    for (int oversampling = 1; oversampling <= (quick ? 1 : 3); ++oversampling)
+        configs.add({ "oversampling " + juce::String(1 << oversampling) + "x", 48000.0,
+                      { { "LowCut Freq", 100.0f }, { "HighCut Freq", 16000.0f }, { "Peak Freq", 8000.0f }, { "Peak Gain", 12.0f },
+                        { "LowCut Slope", 3.0f }, { "HighCut Slope", 3.0f }, { "Oversampling", (float) oversampling } } });
+
+    return configs;
+}
+
+// the chain as juce designs it, at the rate the processor designs at (host x oversampling)
+juce::Array<juce::dsp::IIR::Coefficients<double>::Ptr> makeReferenceChain(const ChainSettings& cs, double sampleRate, bool roundToFloat)
+{
+    juce::Array<juce::dsp::IIR::Coefficients<double>::Ptr> chain;
+
+    if(! cs.lowCutBypassed)
+        for (auto* c : makeLowCutFilter<double>(cs, sampleRate))
+            chain.add(c);
+
+    if(! cs.peakBypassed)
+        chain.add(makePeakFilter<double>(cs, sampleRate));
+
+    const auto& extra = cs.extraPeaks;
+
+    for (int i = 0; i < extra.numBands; ++i)
+        if(! extra.bypassed[(size_t) i])
+            chain.add(juce::dsp::IIR::Coefficients<double>::makePeakFilter(sampleRate, extra.freq[(size_t) i], extra.q[(size_t) i],
+                                                                           juce::Decibels::decibelsToGain((double) extra.gainInDecibels[(size_t) i])));
+
+    if(! cs.highCutBypassed)
+        for (auto* c : makeHighCutFilter<double>(cs, sampleRate))
+            chain.add(c);
+
+    if(roundToFloat)
+        for (auto& c : chain)
+            for (auto& value : c->coefficients)
+                value = (double) (float) value;
+
+    return chain;
+}
+
+// channel 0's impulse response, however late it comes out. Also the largest difference
+// between any other channel and channel 0.
+template <typename SampleType>
+std::vector<double> measureImpulseResponse(SimpleEQAudioProcessor& processor, double sampleRate, int length, double& channelMismatch)
+{
+    constexpr int blockSize = 512;
+
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    const auto numChannels = processor.getMainBusNumInputChannels();
+    juce::AudioBuffer<SampleType> buffer (numChannels, blockSize);
+    juce::MidiBuffer midi;
+
+    std::vector<double> response;
+    response.reserve((size_t) length);
+
+    for (int position = 0; (int) response.size() < length; position += blockSize)
+    {
+        buffer.clear();
+
+        if(position == 0)
+            for (int ch = 0; ch < numChannels; ++ch)
+                buffer.setSample(ch, 0, (SampleType) 1);
+
+        processor.processBlock(buffer, midi);
+
+        for (int i = 0; i < blockSize && (int) response.size() < length; ++i)
+        {
+            auto y = (double) buffer.getSample(0, i);
+
+            for (int ch = 1; ch < numChannels; ++ch)
+                channelMismatch = juce::jmax(channelMismatch, std::abs((double) buffer.getSample(ch, i) - y));
+
+            response.push_back(y);
+        }
+    }
+
+    processor.releaseResources();
+    return response;
+}
+
+// |H(f)| from the impulse response, one DFT bin at exactly f
+double getMeasuredMagnitude(const std::vector<double>& response, double frequency, double sampleRate)
+{
+    auto w = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+    std::complex<double> rotation (std::cos(w), -std::sin(w)), phasor (1.0, 0.0), sum;
+
+    for (auto h : response)
+    {
+        sum += h * phasor;
+        phasor *= rotation;
+    }
+
+    return std::abs(sum);
+}
+
+juce::var verifyResponse(SimpleEQAudioProcessor& processor, const Tolerances& tolerances, bool quick, bool& passed)
+{
+    constexpr int numFrequencies = 64;
+
+    juce::Array<juce::var> failures;
+    auto worstError = 0.0;
+    juce::String worstConfig;
+    auto numChecked = 0;
+
+    // the same view of the parameters the processor's designer reads
+    ParameterSnapshot parameters (processor.apvts);
+
+    for (const auto& config : makeResponseConfigs(quick))
+    {
+        applySettings(processor, config.settings);
+
+        auto cs = parameters.getChainSettings();
+        auto factor = parameters.getOversamplingFactor();
+
+        // two seconds, so even a narrow low peak has rung out
+        auto responseLength = (int) (config.sampleRate * 2.0);
+
+        // the oversampling filters roll off above 0.4 of the host rate
+        auto topFrequency = config.sampleRate * (factor > 1 ? 0.4 : 0.45);
+
+        for (auto isDouble : { false, true })
+        {
+            auto channelMismatch = 0.0;
+            auto response = isDouble ? measureImpulseResponse<double>(processor, config.sampleRate, responseLength, channelMismatch)
+                                     : measureImpulseResponse<float>(processor, config.sampleRate, responseLength, channelMismatch);
+
+            auto reference = makeReferenceChain(cs, config.sampleRate * factor, ! isDouble);
+            auto tolerance = factor > 1 ? tolerances.oversampledDb : (isDouble ? tolerances.doubleDb : tolerances.floatDb);
+            auto configError = 0.0;
+
+            for (int k = 0; k < numFrequencies; ++k)
+            {
+                auto frequency = juce::mapToLog10((double) k / (numFrequencies - 1), 20.0, topFrequency);
+
+                auto expected = 1.0;
+
+                for (auto& c : reference)
+                    expected *= c->getMagnitudeForFrequency(frequency, config.sampleRate * factor);
+
+                auto measuredDb = juce::Decibels::gainToDecibels(getMeasuredMagnitude(response, frequency, config.sampleRate), tolerances.floorDb);
+                auto expectedDb = juce::Decibels::gainToDecibels(expected, tolerances.floorDb);
+
+                configError = juce::jmax(configError, std::abs(measuredDb - expectedDb));
+            }
+
+            ++numChecked;
+
+            if(configError > worstError)
+            {
+                worstError = configError;
+                worstConfig = config.name + (isDouble ? " (double)" : " (float)");
+            }
+
+            if(configError > tolerance || channelMismatch > 1.0e-6)
+            {
+                auto* failure = new juce::DynamicObject();
+                failure->setProperty("config", config.name);
+                failure->setProperty("precision", isDouble ? "double" : "float");
+                failure->setProperty("errorDb", configError);
+                failure->setProperty("toleranceDb", tolerance);
+                failure->setProperty("channelMismatch", channelMismatch);
+                failures.add(juce::var(failure));
+
+                std::cerr << "response FAILED: " << config.name << (isDouble ? " (double)" : " (float)")
+                          << ", off by " << configError << " dB" << std::endl;
+            }
+        }
+    }
+
+    passed = passed && failures.isEmpty();
+
+    auto* result = new juce::DynamicObject();
+    result->setProperty("checked", numChecked);
+    result->setProperty("worstErrorDb", worstError);
+    result->setProperty("worstConfig", worstConfig);
+    result->setProperty("failures", failures);
+    return juce::var(result);
+}
+
+juce::Array<VerifyConfig> makeGoldenConfigs()
+{
+    return {
+        { "default", 48000.0, {} },
+        { "steep", 48000.0, { { "LowCut Freq", 120.0f }, { "HighCut Freq", 9000.0f }, { "LowCut Slope", 3.0f },
+                              { "HighCut Slope", 3.0f }, { "Peak Freq", 2500.0f }, { "Peak Gain", -12.0f }, { "Peak Q", 4.0f } } },
+        { "bands", 44100.0, { { "Peak Bands", 7.0f }, { "Peak Gain", 6.0f }, { "Peak 3 Gain", -9.0f }, { "Peak 5 Gain", 12.0f },
+                              { "Peak 8 Gain", -3.0f } } },
+        { "oversampled", 48000.0, { { "Oversampling", 2.0f }, { "Peak Freq", 12000.0f }, { "Peak Gain", 9.0f },
+                                    { "HighCut Freq", 18000.0f }, { "HighCut Slope", 2.0f } } },
+        { "dynamic", 48000.0, { { "Peak Freq", 1000.0f }, { "Peak Gain", 6.0f }, { "Peak Dynamic", 1.0f },
+                                { "Peak Threshold", -30.0f }, { "Peak Ratio", 4.0f } } },
+        { "linear", 48000.0, { { "Phase Mode", 1.0f }, { "LowCut Freq", 200.0f }, { "LowCut Slope", 2.0f },
+                               { "Peak Freq", 3000.0f }, { "Peak Gain", 6.0f } } }
+    };
+}
+
+// a second of noise through the config, 512 sample blocks, float
+juce::AudioBuffer<float> renderGolden(SimpleEQAudioProcessor& processor, const VerifyConfig& config)
+{
+    constexpr int blockSize = 512;
+    const auto length = (int) config.sampleRate;
+    const auto numChannels = processor.getMainBusNumInputChannels();
+
+    applySettings(processor, config.settings);
+    processor.setRateAndBufferSizeDetails(config.sampleRate, blockSize);
+    processor.prepareToPlay(config.sampleRate, blockSize);
+
+    // empty if linear phase couldn't get its kernel in, the caller fails it
+    if(! processor.waitForLinearPhaseKernel())
+    {
+        processor.releaseResources();
+        return {};
+    }
+
+    juce::AudioBuffer<float> output (numChannels, length);
+    juce::Random random (1234);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < length; ++i)
+            output.setSample(ch, i, random.nextFloat() * 0.5f - 0.25f);
+
+    juce::MidiBuffer midi;
+
+    for (int start = 0; start < length; start += blockSize)
+    {
+        juce::AudioBuffer<float> block (output.getArrayOfWritePointers(), numChannels, start, juce::jmin(blockSize, length - start));
+        processor.processBlock(block, midi);
+    }
+
+    processor.releaseResources();
+    return output;
+}
+
+juce::var verifyGolden(SimpleEQAudioProcessor& processor, const juce::File& directory, const Tolerances& tolerances,
+                       bool update, bool& passed)
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    juce::Array<juce::var> results;
+
+    for (const auto& config : makeGoldenConfigs())
+    {
+        auto rendered = renderGolden(processor, config);
+        auto file = directory.getChildFile(config.name + ".wav");
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty("config", config.name);
+
+        if(rendered.getNumSamples() == 0)
+        {
+            passed = false;
+            result->setProperty("passed", false);
+            std::cerr << "golden FAILED: " << config.name << ", the linear phase kernel didn't load" << std::endl;
+        }
+        else if(update)
+        {
+            directory.createDirectory();
+            file.deleteFile();
+
+            juce::WavAudioFormat wav;
+            auto stream = file.createOutputStream();
+            std::unique_ptr<juce::AudioFormatWriter> writer;
+
+            if(stream != nullptr)
+                writer.reset(wav.createWriterFor(stream.get(), config.sampleRate, (unsigned int) rendered.getNumChannels(), 32, {}, 0));
+
+            if(writer != nullptr)
+                stream.release(); // the writer owns it now
+
+            auto written = writer != nullptr && writer->writeFromAudioSampleBuffer(rendered, 0, rendered.getNumSamples());
+            result->setProperty("written", written);
+            passed = passed && written;
+        }
+        else
+        {
+            std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor(file));
+            auto matches = reader != nullptr && (int) reader->numChannels == rendered.getNumChannels()
+                            && reader->lengthInSamples == rendered.getNumSamples();
+            auto maxError = 0.0;
+
+            if(matches)
+            {
+                juce::AudioBuffer<float> golden (rendered.getNumChannels(), rendered.getNumSamples());
+                reader->read(&golden, 0, golden.getNumSamples(), 0, true, true);
+
+                for (int ch = 0; ch < golden.getNumChannels(); ++ch)
+                    for (int i = 0; i < golden.getNumSamples(); ++i)
+                        maxError = juce::jmax(maxError, (double) std::abs(golden.getSample(ch, i) - rendered.getSample(ch, i)));
+            }
+
+            auto ok = matches && maxError <= tolerances.golden;
+            passed = passed && ok;
+
+            result->setProperty("maxError", matches ? juce::var(maxError) : juce::var("missing or a different length"));
+            result->setProperty("passed", ok);
+
+            if(! ok)
+                std::cerr << "golden FAILED: " << config.name << (matches ? ", max error " + juce::String(maxError)
+                                                                          : ", no usable " + file.getFullPathName()) << std::endl;
+        }
+
+        results.add(juce::var(result));
+    }
+
+    return results;
+}
+
+juce::var verifyThroughput(SimpleEQAudioProcessor& processor, const juce::var& baseline, const Tolerances& tolerances,
+                           int numSamples, bool& passed)
+{
+    const juce::Array<VerifyConfig> configs {
+        { "12 dB/oct", 48000.0, { { "Peak Gain", 6.0f } } },
+        { "48 dB/oct", 48000.0, { { "Peak Gain", 6.0f }, { "LowCut Slope", 3.0f }, { "HighCut Slope", 3.0f } } },
+        { "16 bands", 48000.0, { { "Peak Bands", (float) (MaxPeakBands - 1) } } },
+        { "oversampled 4x", 48000.0, { { "Peak Gain", 6.0f }, { "Oversampling", 2.0f } } },
+        { "dynamic", 48000.0, { { "Peak Gain", 6.0f }, { "Peak Dynamic", 1.0f }, { "Peak Threshold", -40.0f } } }
+    };
+
+    const auto numChannels = processor.getMainBusNumInputChannels();
+    juce::AudioBuffer<float> buffer (numChannels, 512);
+    juce::Array<juce::var> results;
+
+    for (const auto& config : configs)
+    {
+        applySettings(processor, config.settings);
+
+        auto finite = true;
+        auto nsPerSample = timeProcessBlock(processor, buffer, config.sampleRate, 512, numSamples, &finite) / numChannels;
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty("config", config.name);
+        result->setProperty("nsPerSample", nsPerSample);
+        result->setProperty("finite", finite);
+
+        // a timing of inf / NaN blocks (or of the idle path they can end up in) means nothing
+        if(! finite)
+        {
+            passed = false;
+            result->setProperty("passed", false);
+            std::cerr << "throughput FAILED: " << config.name << ", the output isn't finite" << std::endl;
+        }
+
+        // the baseline is an earlier --verify --out, matched by name
+        if(auto* entries = baseline["throughput"].getArray())
+        {
+            for (const auto& entry : *entries)
+            {
+                if(entry["config"].toString() != config.name)
+                    continue;
+
+                auto before = (double) entry["nsPerSample"];
+                auto ok = finite && nsPerSample <= before * tolerances.maxSlowdown;
+                passed = passed && ok;
+
+                result->setProperty("baselineNsPerSample", before);
+                result->setProperty("passed", ok);
+
+                if(! ok)
+                    std::cerr << "throughput FAILED: " << config.name << ", " << nsPerSample << " ns/sample against "
+                              << before << " before" << std::endl;
+            }
+        }
+
+        results.add(juce::var(result));
+    }
+
+    return results;
+}
+
+void printVerifyUsage()
+{
+    std::cerr << "usage: SimpleEQBench --verify [--out results.json] [--quick] [--samples n] [--baseline earlier.json]\n"
+                 "                     [--golden dir [--update-golden]] [--tolerance-db x] [--max-slowdown x]" << std::endl;
+}
+
+int runVerify(const juce::StringArray& args)
+{
+    juce::File outputFile, baselineFile, goldenDirectory;
+    Tolerances tolerances;
+    auto quick = false, updateGolden = false;
+    auto numSamples = 1 << 16;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto& arg = args[i];
+        auto hasValue = i + 1 < args.size();
+
+        if(arg == "--verify")
+            continue;
+        else if(arg == "--out" && hasValue)
+            outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+        else if(arg == "--baseline" && hasValue)
+            baselineFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+        else if(arg == "--golden" && hasValue)
+            goldenDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+        else if(arg == "--update-golden")
+            updateGolden = true;
+        else if(arg == "--quick")
+            quick = true;
+        else if(arg == "--samples" && hasValue)
+            numSamples = juce::jmax(16, args[++i].getIntValue());
+        else if(arg == "--tolerance-db" && hasValue)
+            tolerances.floatDb = tolerances.doubleDb = args[++i].getDoubleValue();
+        else if(arg == "--max-slowdown" && hasValue)
+            tolerances.maxSlowdown = args[++i].getDoubleValue();
+        else
+        {
+            printVerifyUsage();
+            return 1;
+        }
+    }
+
+    juce::var baseline;
+
+    if(baselineFile != juce::File())
+    {
+        baseline = juce::JSON::parse(baselineFile);
+
+        if(! baseline.isObject())
+        {
+            std::cerr << "can't read " << baselineFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    SimpleEQAudioProcessor processor;
+    processor.setSmoothing(0.0, 32); // no glide, every run starts on its own settings
+
+    auto passed = true;
+    auto root = std::make_unique<juce::DynamicObject>();
+    root->setProperty("cpu", juce::SystemStats::getCpuModel());
+    root->setProperty("time", juce::Time::getCurrentTime().toISO8601(true));
+    root->setProperty("response", verifyResponse(processor, tolerances, quick, passed));
+
+    if(goldenDirectory != juce::File())
+        root->setProperty("golden", verifyGolden(processor, goldenDirectory, tolerances, updateGolden, passed));
+
+    root->setProperty("throughput", verifyThroughput(processor, baseline, tolerances, numSamples, passed));
+    root->setProperty("passed", passed);
+
+    auto json = juce::JSON::toString(juce::var(root.release()));
+
+    if(outputFile == juce::File())
+        std::cout << json << std::endl;
+    else if(! outputFile.replaceWithText(json))
+        std::cerr << "can't write " << outputFile.getFullPathName() << std::endl;
+
+    std::cerr << (passed ? "verify passed" : "verify FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+
+    for (int i = 1; i < argc; ++i)
+        args.add(juce::CharPointer_UTF8(argv[i]));
+
+    if(args.contains("--verify"))
+        return runVerify(args);
+
+    juce::File outputFile;
+    auto quick = false;
+    auto numSamples = 1 << 16;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        if(args[i] == "--out" && i + 1 < args.size())
+            outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+        else if(args[i] == "--quick")
+            quick = true;
+        else if(args[i] == "--samples" && i + 1 < args.size())
+            numSamples = juce::jmax(16, args[++i].getIntValue());
+        else
+        {
+            std::cerr << "usage: SimpleEQBench [--out results.json] [--quick] [--samples n]" << std::endl;
+            printVerifyUsage();
+            return 1;
+        }
+    }
+
+    juce::Array<int> blockSizes;
+    juce::Array<double> sampleRates;
+
+    if(quick)
+    {
+        blockSizes = { 64, 512 };
+        sampleRates = { 48000.0 };
+    }
+    else
+    {
+        blockSizes = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+        sampleRates = { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    }
+
+    SimpleEQAudioProcessor processor;
+    processor.setSmoothing(0.0, 32); // no glide, every run starts on its own settings
+
+    const auto numChannels = processor.getMainBusNumInputChannels();
+    juce::AudioBuffer<float> buffer (numChannels, blockSizes.getLast());
+
+    juce::Array<juce::var> processResults;
+
+    for (int lowCutSlope = Slope_12; lowCutSlope <= Slope_48; ++lowCutSlope)
+    {
+        for (int highCutSlope = Slope_12; highCutSlope <= Slope_48; ++highCutSlope)
+        {
+            for (int bypassed = 0; bypassed < 8; ++bypassed)
+            {
+                BenchConfig config;
+                config.lowCutSlope = static_cast<Slope>(lowCutSlope);
+                config.highCutSlope = static_cast<Slope>(highCutSlope);
+                config.lowCutBypassed = (bypassed & 1) != 0;
+                config.peakBypassed = (bypassed & 2) != 0;
+                config.highCutBypassed = (bypassed & 4) != 0;
+
+                applyConfig(processor, config);
+
+                for (auto sampleRate : sampleRates)
+                {
+                    for (auto blockSize : blockSizes)
+                    {
+                        auto* result = new juce::DynamicObject();
+                        result->setProperty("lowCutSlope", 12 * (lowCutSlope + 1));
+                        result->setProperty("highCutSlope", 12 * (highCutSlope + 1));
+                        result->setProperty("lowCutBypassed", config.lowCutBypassed);
+                        result->setProperty("peakBypassed", config.peakBypassed);
+                        result->setProperty("highCutBypassed", config.highCutBypassed);
+                        result->setProperty("sampleRate", sampleRate);
+                        result->setProperty("blockSize", blockSize);
+                        result->setProperty("nsPerSample", timeProcessBlock(processor, buffer, sampleRate, blockSize, numSamples)
+                                                               / numChannels);
+                        processResults.add(juce::var(result));
+                    }
+                }
+            }
+
+            std::cerr << "." << std::flush;
+        }
+    }
+
+    std::cerr << std::endl;
+
+    auto root = std::make_unique<juce::DynamicObject>();
+    root->setProperty("cpu", juce::SystemStats::getCpuModel());
+    root->setProperty("numCpus", juce::SystemStats::getNumCpus());
+    root->setProperty("time", juce::Time::getCurrentTime().toISO8601(true));
+   #if JUCE_DEBUG
+    root->setProperty("build", "debug");
+   #else
+    root->setProperty("build", "release");
+   #endif
+    root->setProperty("channels", numChannels);
+    root->setProperty("samplesPerRun", numSamples);
+    root->setProperty("processBlock", processResults);
+
+    root->setProperty("bands", benchBands(processor, buffer, numSamples));
+    root->setProperty("dynamic", benchDynamic(processor, buffer, numSamples));
+
+    applyConfig(processor, BenchConfig());
+    root->setProperty("signals", benchSignals(processor, numSamples));
+    root->setProperty("design", benchDesign(48000.0));
+    root->setProperty("instances", benchInstances(quick ? 8 : 64));
+    root->setProperty("state", benchState(quick ? 8 : 256, quick ? 100 : 5000));
+    root->setProperty("coefficientTables", benchTableAccuracy(quick));
+
+    auto json = juce::JSON::toString(juce::var(root.release()));
+
+    if(outputFile == juce::File())
+    {
+        std::cout << json << std::endl;
+    }
+    else if(! outputFile.replaceWithText(json))
+    {
+        std::cerr << "can't write " << outputFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,327 @@
+/*
+  ==============================================================================
+
+    SimpleEQRender: runs audio files through SimpleEQ without a host.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+
+// Every file gets its own SimpleEQAudioProcessor and goes through prepareToPlay / processBlock
+// exactly like in a host, so the output is bit-identical to the plugin for the same settings.
+// Audio is streamed through in fixed size chunks, so memory use doesn't depend on file length,
+// and files are rendered in parallel on a thread pool, one file per job.
+//
+//  SimpleEQRender --out <dir> [--bank <file> --preset <name or number>] [--set "<parameter id>=<value>"]...
+//                 [--threads n] [--chunk n] files...
+//
+// Parameter ids are the ones from createParameterLayout, values are in the parameter's own
+// units (Hz, dB, slope index 0..3, bypass 0/1). A preset from a bank (see PresetBank.h) is
+// applied first, so --set can change it. Output is always 32 bit float WAV.
+
+namespace
+{
+using ParameterSettings = juce::Array<std::pair<juce::String, float>>;
+
+struct PresetChoice
+{
+    juce::File bank;
+    juce::String preset;    // a name, or a number counting from 1
+};
+
+void printUsage()
+{
+    std::cout << "usage: SimpleEQRender --out <dir> [--bank <file> --preset <name or number>] "
+                 "[--set \"<parameter id>=<value>\"]... [--threads n] [--chunk n] files..." << std::endl;
+}
+
+void printParameters(SimpleEQAudioProcessor& processor)
+{
+    std::cout << "parameters:" << std::endl;
+
+    for (auto* p : processor.getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(p))
+            std::cout << "  \"" << ranged->paramID << "\"  "
+                      << ranged->getNormalisableRange().start << " .. "
+                      << ranged->getNormalisableRange().end << std::endl;
+}
+
+juce::String applyPreset(SimpleEQAudioProcessor& processor, const PresetChoice& choice)
+{
+    if(choice.bank == juce::File())
+        return {};
+
+    if(! processor.loadPresetBank(choice.bank))
+        return "can't open preset bank " + choice.bank.getFullPathName();
+
+    const auto& bank = processor.getPresetBank();
+    auto index = bank.indexOf(choice.preset);
+
+    if(index < 0 && choice.preset.containsOnly("0123456789"))
+        index = choice.preset.getIntValue() - 1;
+
+    if(! processor.applyPreset(index))
+        return "no preset \"" + choice.preset + "\" in " + choice.bank.getFileName();
+
+    return {};
+}
+
+// same path as host automation: value -> normalised -> apvts
+juce::String applySettings(SimpleEQAudioProcessor& processor, const ParameterSettings& settings)
+{
+    for (const auto& s : settings)
+    {
+        auto* param = processor.apvts.getParameter(s.first);
+
+        if(param == nullptr)
+            return "unknown parameter \"" + s.first + "\"";
+
+        param->setValueNotifyingHost(param->convertTo0to1(s.second));
+    }
+
+    return {};
+}
+
+class RenderJob : public juce::ThreadPoolJob
+{
+public:
+    RenderJob(const juce::File& in, const juce::File& out, const PresetChoice& p, const ParameterSettings& s, int chunk)
+        : juce::ThreadPoolJob(in.getFileName()), input(in), output(out), preset(p), settings(s), chunkSize(chunk)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        error = render();
+        return jobHasFinished;
+    }
+
+    const juce::String& getError() const noexcept { return error; }
+    const juce::File& getInput() const noexcept { return input; }
+
+private:
+    juce::String render()
+    {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor(input));
+
+        if(reader == nullptr)
+            return "can't read " + input.getFullPathName();
+
+        auto numChannels = (int) reader->numChannels;
+        auto sampleRate = reader->sampleRate;
+
+        SimpleEQAudioProcessor processor;
+
+        auto result = applyPreset(processor, preset);
+
+        if(result.isEmpty())
+            result = applySettings(processor, settings);
+
+        if(result.isNotEmpty())
+            return result;
+
+        // same layout in and out, whatever the file has, and no sidechain
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+        layout.inputBuses.add(juce::AudioChannelSet::disabled());
+        layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+
+        if(! processor.setBusesLayout(layout))
+            return "unsupported channel count " + juce::String(numChannels);
+
+        processor.setRateAndBufferSizeDetails(sampleRate, chunkSize);
+        processor.prepareToPlay(sampleRate, chunkSize);
+
+        if(! processor.waitForLinearPhaseKernel())
+            return "the linear phase kernel didn't load";
+
+        output.deleteFile();
+        auto stream = output.createOutputStream();
+
+        if(stream == nullptr)
+            return "can't write " + output.getFullPathName();
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer (wav.createWriterFor(stream.get(), sampleRate,
+                                                                             (unsigned int) numChannels,
+                                                                             32, reader->metadataValues, 0));
+
+        if(writer == nullptr)
+            return "can't create a writer for " + output.getFullPathName();
+
+        stream.release(); // the writer owns it now
+
+        juce::AudioBuffer<float> buffer (numChannels, chunkSize);
+        juce::MidiBuffer midi;
+
+        // with oversampling or linear phase on the output is late by the latency, drop that much from the
+        // start and run zeros through at the end, like a host's delay compensation would
+        const juce::int64 latency = processor.getLatencySamples();
+        const auto totalLength = reader->lengthInSamples + latency;
+
+        for (juce::int64 position = 0; position < totalLength; position += chunkSize)
+        {
+            auto numSamples = (int) juce::jmin((juce::int64) chunkSize, totalLength - position);
+
+            // past the end of the file the reader fills in zeros
+            reader->read(&buffer, 0, numSamples, position, true, true);
+
+            // the last chunk can be short, hand processBlock exactly the samples we have
+            juce::AudioBuffer<float> chunk (buffer.getArrayOfWritePointers(), numChannels, numSamples);
+            processor.processBlock(chunk, midi);
+
+            auto skip = (int) juce::jlimit((juce::int64) 0, (juce::int64) numSamples, latency - position);
+
+            if(skip < numSamples && ! writer->writeFromAudioSampleBuffer(chunk, skip, numSamples - skip))
+                return "write failed for " + output.getFullPathName();
+        }
+
+        processor.releaseResources();
+        return {};
+    }
+
+    juce::File input, output;
+    PresetChoice preset;
+    ParameterSettings settings;
+    int chunkSize;
+
+    juce::String error;
+};
+}
+
+int main (int argc, char* argv[])
+{
+    // the processor's parameters and the coefficient designer want the message manager around
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+
+    for (int i = 1; i < argc; ++i)
+        args.add(juce::CharPointer_UTF8(argv[i]));
+
+    juce::File outputDirectory;
+    ParameterSettings settings;
+    PresetChoice preset;
+    juce::Array<juce::File> inputs;
+    auto numThreads = juce::SystemStats::getNumCpus();
+    auto chunkSize = 512;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto& arg = args[i];
+        auto hasValue = i + 1 < args.size();
+
+        if(arg == "--out" && hasValue)
+        {
+            outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+        }
+        else if(arg == "--set" && hasValue)
+        {
+            auto setting = args[++i];
+
+            if(! setting.containsChar('='))
+            {
+                std::cerr << "expected \"<parameter id>=<value>\", got \"" << setting << "\"" << std::endl;
+                return 1;
+            }
+
+            settings.add({ setting.upToLastOccurrenceOf("=", false, false).trim(),
+                           setting.fromLastOccurrenceOf("=", false, false).trim().getFloatValue() });
+        }
+        else if(arg == "--bank" && hasValue)
+        {
+            preset.bank = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+        }
+        else if(arg == "--preset" && hasValue)
+        {
+            preset.preset = args[++i];
+        }
+        else if(arg == "--threads" && hasValue)
+        {
+            numThreads = juce::jmax(1, args[++i].getIntValue());
+        }
+        else if(arg == "--chunk" && hasValue)
+        {
+            chunkSize = juce::jmax(1, args[++i].getIntValue());
+        }
+        else if(arg == "--help" || arg.startsWith("--"))
+        {
+            printUsage();
+            SimpleEQAudioProcessor processor;
+            printParameters(processor);
+            return arg == "--help" ? 0 : 1;
+        }
+        else
+        {
+            inputs.add(juce::File::getCurrentWorkingDirectory().getChildFile(arg));
+        }
+    }
+
+    if(inputs.isEmpty() || outputDirectory == juce::File() || (preset.bank == juce::File()) != preset.preset.isEmpty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    // check the bank and the ids up front rather than failing every job the same way
+    {
+        SimpleEQAudioProcessor processor;
+        auto result = applyPreset(processor, preset);
+
+        if(result.isEmpty())
+            result = applySettings(processor, settings);
+
+        if(result.isNotEmpty())
+        {
+            std::cerr << result << std::endl;
+            printParameters(processor);
+            return 1;
+        }
+    }
+
+    if(! outputDirectory.createDirectory())
+    {
+        std::cerr << "can't create " << outputDirectory.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    juce::OwnedArray<RenderJob> jobs; // declared first so the pool is gone before the jobs are
+    juce::ThreadPool pool (numThreads);
+
+    auto start = juce::Time::getMillisecondCounterHiRes();
+
+    for (const auto& input : inputs)
+    {
+        auto output = outputDirectory.getChildFile(input.getFileNameWithoutExtension() + ".wav");
+        auto* job = jobs.add(new RenderJob(input, output, preset, settings, chunkSize));
+        pool.addJob(job, false);
+    }
+
+    // jobs run on the pool, so just wait for them here
+    int numFailed = 0;
+
+    for (auto* job : jobs)
+    {
+        pool.waitForJobToFinish(job, -1);
+
+        if(job->getError().isNotEmpty())
+        {
+            std::cerr << job->getInput().getFileName() << ": " << job->getError() << std::endl;
+            ++numFailed;
+        }
+    }
+
+    auto seconds = (juce::Time::getMillisecondCounterHiRes() - start) / 1000.0;
+    auto numRendered = inputs.size() - numFailed;
+
+    std::cout << numRendered << " of " << inputs.size() << " files rendered on " << numThreads
+              << " threads in " << seconds << " s ("
+              << (seconds > 0 ? numRendered / seconds : 0.0) << " files/sec)" << std::endl;
+
+    return numFailed == 0 ? 0 : 1;
+}